@@ -0,0 +1,174 @@
+/*
+*	ChannelModel.h, Copyright Jonathan Mackey 2026
+*
+*	Degrades synthesized samples the way a radio channel would, to qualify
+*	decoders (Linux and macOS hosts only.)  The impairments are:
+*
+*	- White Gaussian noise at a given SNR relative to the full carrier,
+*	  measured over the whole sample bandwidth (half the sample rate for a
+*	  real carrier, the sample rate for baseband.)
+*	- Slow fading.  The gain moves linearly between random levels from 0
+*	  to the fade depth below the carrier, one level per fade period.
+*	- Impulsive noise.  Time is divided into slots of the burst length and
+*	  each slot is a burst with the probability that gives the burst rate.
+*	  A burst adds noise at its own level.
+*	- Carrier offset, baseband only.  For a real carrier synthesize at the
+*	  offset frequency instead.
+*	- Edge jitter.  EdgeOffset() returns a Gaussian offset in samples for
+*	  each symbol edge, applied either by WWVBSynthesizer to the tenths it
+*	  writes or directly to a stream of edge times.
+*
+*	All of the randomness comes from a counter based generator: a keyed
+*	integer hash of the absolute sample, slot or edge index.  The noise,
+*	fade levels, bursts and jitter therefore depend only on the seed and
+*	the position in the stream, not on how the stream is split into blocks
+*	(the faded gain to within rounding), and any part of a run can be
+*	reproduced without generating what precedes it (see Seek().)  Noise is the sum of
+*	four 16 bit uniforms (Irwin-Hall), which is within 3.5 sigma of the
+*	mean, and is generated 8 or 4 lanes at a time when compiled for AVX2 or
+*	SSE2.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef ChannelModel_h
+#define ChannelModel_h
+
+#if defined __linux__ || defined __MACH__
+#include <inttypes.h>
+#include <vector>
+
+class ChannelModel
+{
+public:
+	/*
+	*	inChannels is 1 for a real carrier or 2 for interleaved I/Q.  All of
+	*	the impairments are off until set.
+	*/
+							ChannelModel(
+								uint32_t				inSampleRate,
+								uint32_t				inChannels,
+								uint64_t				inSeed);
+	/*
+	*	The full carrier amplitude the SNR and burst levels are relative to
+	*	(default 0.9, as WWVBSynthesizer.)
+	*/
+	void					SetSignalLevel(
+								float					inLevel);
+	/*
+	*	inSNR in dB.  Set NAN for no noise.
+	*/
+	void					SetNoise(
+								float					inSNR);
+	/*
+	*	inDepth in dB, inPeriod in seconds.  A depth of 0 is no fading.
+	*/
+	void					SetFading(
+								float					inDepth,
+								float					inPeriod);
+	/*
+	*	inRate bursts per second, inLength in seconds, inLevel in dB relative
+	*	to the carrier.  A rate of 0 is no bursts.
+	*/
+	void					SetImpulses(
+								float					inRate,
+								float					inLength,
+								float					inLevel);
+	void					SetCarrierOffset(
+								float					inHz);
+	/*
+	*	inJitter is the standard deviation in seconds.  Offsets are limited
+	*	to less than half a tenth of a second so edges stay in order.
+	*/
+	void					SetEdgeJitter(
+								float					inJitter);
+	inline bool				HasEdgeJitter(void) const
+								{return(mJitterSamples != 0);}
+	/*
+	*	Applies the channel in place to the next inSamples samples of the
+	*	stream.  ioBlock holds inSamples * channels floats.
+	*/
+	void					Process(
+								float*					ioBlock,
+								uint32_t				inSamples);
+	/*
+	*	The jitter of edge inEdge, in samples.  Edges are numbered by the
+	*	caller, e.g. WWVBSynthesizer numbers every tenth from the start of
+	*	the stream.
+	*/
+	int32_t					EdgeOffset(
+								uint64_t				inEdge) const;
+	/*
+	*	Sets the stream position, in samples, of the next Process().
+	*/
+	inline void				Seek(
+								uint64_t				inSample)
+								{mSample = inSample;}
+	inline uint64_t			Position(void) const
+								{return(mSample);}
+	/*
+	*	The generator.  Exposed so the distribution can be checked.
+	*/
+	static uint32_t			Hash(
+								uint32_t				inValue);
+	static float			Gaussian(
+								uint32_t				inKey,
+								uint32_t				inCounter);
+	static const char*		InstructionSet(void);
+protected:
+	enum EStream
+	{
+		eNoiseStream,
+		eFadeStream,
+		eBurstStream,
+		eJitterStream
+	};
+	uint32_t				mSampleRate;
+	uint32_t				mChannels;
+	uint64_t				mSeed;
+	uint64_t				mSample;
+	float					mSignalLevel;
+	float					mSNR;
+	float					mNoiseSigma;	// Per float
+	float					mFadeDepth;
+	uint32_t				mFadeSamples;	// 0 = no fading
+	float					mBurstRate;
+	float					mBurstLevel;
+	float					mBurstSigma;	// Noise sigma during a burst
+	uint32_t				mBurstSamples;	// 0 = no bursts
+	uint32_t				mBurstThreshold;	// Of a slot's hash
+	double					mOffset;		// Hz
+	float					mJitterSamples;	// Standard deviation
+	int32_t					mJitterLimit;
+	std::vector<float>		mNoise;
+
+	uint32_t				Key(
+								EStream					inStream,
+								uint64_t				inHigh) const;
+	float					FadeGain(
+								uint64_t				inKnot) const;
+	bool					InBurst(
+								uint64_t				inSlot) const;
+	void					UpdateNoise(void);
+	void					Rotate(
+								float*					ioBlock,
+								uint32_t				inSamples);
+};
+#endif
+
+#endif // ChannelModel_h
@@ -0,0 +1,85 @@
+/*
+*	CivilCalendar.h, Copyright Jonathan Mackey 2026
+*
+*	Proleptic Gregorian calendar arithmetic.
+*
+*	Days are counted from 1-MAR-0000.  Starting the count in March places the
+*	leap day at the end of the computational year, which allows the conversions
+*	to be done without any table lookups or month loops.  The algorithms are
+*	from "Euclidean affine functions and their application to calendar
+*	algorithms" by Cassio Neri and Lorenz Schneider (2022), which refines the
+*	days_from_civil/civil_from_days algorithms by Howard Hinnant.
+*
+*	Valid for years 1 to 65535.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef CivilCalendar_h
+#define CivilCalendar_h
+
+#include <inttypes.h>
+
+class CivilCalendar
+{
+public:
+	/*
+	*	Returns the number of days from 1-MAR-0000 to inYear/inMonth/inDay.
+	*	inMonth is 1 to 12, inDay is 1 to 31.  No validation is performed.
+	*/
+	static uint32_t			DaysFromCivil(
+								uint16_t				inYear,
+								uint8_t					inMonth,
+								uint8_t					inDay);
+	/*
+	*	Inverse of DaysFromCivil.
+	*/
+	static void				CivilFromDays(
+								uint32_t				inDays,
+								uint16_t&				outYear,
+								uint8_t&				outMonth,
+								uint8_t&				outDay);
+	static inline bool		IsLeapYear(
+								uint16_t				inYear)
+								{
+									// Years divisible by 100 are only leap years
+									// when also divisible by 400, i.e. by 16.
+									return((inYear & ((inYear % 25) ? 3 : 15)) == 0);
+								}
+	static inline uint8_t	DaysInMonth(
+								uint8_t					inMonth,
+								uint16_t				inYear)
+								{
+									return(inMonth == 2 ? (28 + IsLeapYear(inYear)) :
+										(30 | ((inMonth ^ (inMonth >> 3)) & 1)));
+								}
+	/*
+	*	Returns the day of the year, 1 to 366.
+	*/
+	static uint16_t			DayOfYear(
+								uint16_t				inYear,
+								uint8_t					inMonth,
+								uint8_t					inDay);
+
+	// Days from 1-MAR-0000 to 1-JAN-1970 (Unix time 0)
+	static const uint32_t	kUnixEpochDays = 719468;
+	// Days from 1-MAR-0000 to 1-JAN-2000
+	static const uint32_t	kYear2000Days = 730485;
+};
+
+#endif // CivilCalendar_h
@@ -0,0 +1,84 @@
+/*
+*	DCF77PRN.h, Copyright Jonathan Mackey 2026
+*
+*	The DCF77 pseudo-random phase modulation.
+*
+*	From 200 ms after each second marker DCF77 shifts the carrier phase by
+*	+/-15.6 degrees for each of 512 chips, a chip being 120 carrier cycles
+*	(1.548 ms), so the sequence ends 993 ms into the second.  The chips are
+*	the 511 chip output of a 9 stage LFSR with feedback from stages 5 and 9,
+*	plus a final 0 chip, inverted when the second's time bit is 1.  Here a
+*	chip of 0 advances the phase.  The sequence is the same every second,
+*	so it's computed at compile time (a constant table.)
+*
+*	The firmware transmits WWVB, so only host tools use this:
+*	WWVBSynthesizer sends the modulation and Correlate() checks it in a
+*	second of baseband output (see Host/PRNCheck.cpp.)
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef DCF77PRN_h
+#define DCF77PRN_h
+
+#include <inttypes.h>
+
+class DCF77PRN
+{
+public:
+	static const uint32_t	kChips = 512;
+	static const uint32_t	kCyclesPerChip = 120;
+	static const uint32_t	kCarrierHz = 77500;
+	static const uint32_t	kStartMs = 200;
+	static constexpr float	kDeviation = 15.6f;	// Degrees
+	/*
+	*	Returns chip inIndex, 0 to 511, of the sequence sent for time bit 0.
+	*/
+	static inline uint32_t	Chip(
+								uint32_t				inIndex)
+								{return((sChips.bits[inIndex >> 5] >> (inIndex & 31)) & 1);}
+	/*
+	*	Returns the sample within the second at which chip inIndex starts.
+	*	Chip kChips is the end of the sequence.
+	*/
+	static uint32_t			ChipStart(
+								uint32_t				inIndex,
+								uint32_t				inSampleRate);
+#if defined __linux__ || defined __MACH__
+	/*
+	*	Correlates the chip phases of one second of baseband I/Q, starting at
+	*	the second marker, with the sequence shifted by inLag chips.  The
+	*	phase reference is the carrier before 200 ms.  Returns -1 to 1, near
+	*	1 for time bit 0 and near -1 for time bit 1 at lag 0, and near 0 at
+	*	any other lag.
+	*/
+	static float			Correlate(
+								const float*			inIQ,
+								uint32_t				inSampleRate,
+								int32_t					inLag = 0);
+#endif
+protected:
+	struct SChips
+	{
+		uint32_t	bits[kChips / 32];	// Chip n is bit n
+	};
+	static const SChips		sChips;
+	static constexpr SChips	Sequence(void);
+};
+
+#endif // DCF77PRN_h
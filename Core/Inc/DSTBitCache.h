@@ -0,0 +1,79 @@
+/*
+*	DSTBitCache.h, Copyright Jonathan Mackey 2026
+*
+*	The WWVB DST status bits (57 and 58) for every UTC day of a year.
+*
+*	Bit 57 is the DST state at the end of the UTC day and bit 58 the state
+*	at its start, so a day is one of the four UnixTimeWWVB::eDST values.
+*	Once per year the state of each day is derived from a TimeZoneRule and
+*	packed 2 bits per day into 92 bytes.  A frame then looks up its day of
+*	the year, which replaces counting Sundays for every frame.
+*
+*	The cache is keyed by year, so it's rebuilt when the year rolls over
+*	or the time is set to a different year.  Setting the rule invalidates
+*	it.  The default rule is the US rule for the Eastern time zone.  A rule
+*	without DST, e.g. "MST7" (Arizona) or "HST10" (Hawaii), gives all zeros.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef DSTBitCache_h
+#define DSTBitCache_h
+
+#include "TimeZoneRule.h"
+
+class DSTBitCache
+{
+public:
+							DSTBitCache(void);
+	/*
+	*	Sets the rule the bits are derived from.  nullptr restores the
+	*	default US rule.  inRule must remain valid while it's in use.
+	*/
+	void					SetTimeZoneRule(
+								TimeZoneRule*			inRule);
+	inline TimeZoneRule&	Rule(void)
+								{return(mRule ? *mRule : mUSRule);}
+	inline void				Invalidate(void)
+								{mYear = 0;}
+	/*
+	*	Returns the eDST status of the UTC day inDayOfYear (1 to 366) of
+	*	inYear.
+	*/
+	inline uint8_t			Status(
+								uint16_t				inYear,
+								uint16_t				inDayOfYear)
+								{
+									if (inYear != mYear)
+									{
+										Load(inYear);
+									}
+									uint16_t	index = inDayOfYear - 1;
+									return((mBits[index >> 2] >> ((index & 3) * 2)) & 3);
+								}
+protected:
+	TimeZoneRule*			mRule;
+	TimeZoneRule			mUSRule;
+	uint16_t				mYear;		// Of mBits, 0 = none
+	uint8_t					mBits[92];	// 2 bits per day, day 1 in bits 0-1
+
+	void					Load(
+								uint16_t				inYear);
+};
+
+#endif // DSTBitCache_h
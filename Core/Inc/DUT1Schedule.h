@@ -0,0 +1,109 @@
+/*
+*	DUT1Schedule.h, Copyright Jonathan Mackey 2026
+*
+*	Schedule of DUT1 (UT1 - UTC in tenths of a second) as published in IERS
+*	Bulletin D.
+*
+*	Each entry is the UTC Unix time a DUT1 value takes effect.  As with
+*	LeapSeconds, a cursor into the table is kept so the per minute lookup
+*	is a compare.  The built in table is const so it stays in flash.
+*	Entries can be added at run time, e.g. from a "$PDUT1" sentence
+*	received on the UART config channel, in which case the table is copied
+*	to RAM.  Also as with LeapSeconds, the table is only used from one
+*	context, on the STM32 the main loop.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef DUT1Schedule_h
+#define DUT1Schedule_h
+
+#include "UnixTimeConverter.h"
+
+class DUT1Schedule
+{
+public:
+	struct SDUT1
+	{
+		time32_t	time;			// When tenths takes effect
+		int8_t		tenths;			// -9 to 9
+	};
+	/*
+	*	Returns DUT1 in tenths of a second at inUTC.
+	*/
+	static inline int8_t	DUT1(
+								time32_t				inUTC)
+								{
+									Seek(inUTC);
+									return(sTable[sCursor].tenths);
+								}
+	/*
+	*	Same as above, also returning the span the value applies to, from
+	*	outStart up to outEnd.  outEnd is 0xFFFFFFFF for the last entry.
+	*/
+	static inline int8_t	DUT1(
+								time32_t				inUTC,
+								time32_t&				outStart,
+								time32_t&				outEnd)
+								{
+									Seek(inUTC);
+									outStart = sTable[sCursor].time;
+									outEnd = (sCursor + 1) < sCount ?
+											sTable[sCursor + 1].time : 0xFFFFFFFF;
+									return(sTable[sCursor].tenths);
+								}
+	/*
+	*	Adds or replaces the entry taking effect at inTime.  When the table
+	*	is full the oldest entry is dropped.  Returns false if inTenths is
+	*	out of range.
+	*/
+	static bool				AddEntry(
+								time32_t				inTime,
+								int8_t					inTenths);
+	/*
+	*	Parses a sentence of the form "$PDUT1,YYYYMMDD,[+-]t*hh" where hh is
+	*	the NMEA checksum (the XOR of the characters between $ and *.)
+	*	Returns false if the sentence isn't valid.
+	*/
+	static bool				ParseSentence(
+								const char*				inSentence,
+								time32_t&				outTime,
+								int8_t&					outTenths);
+	static const uint8_t	kMaxEntries = 8;
+protected:
+	static const SDUT1		kDUT1Schedule[];
+	static const SDUT1*		sTable;
+	static uint8_t			sCount;
+	static uint8_t			sCursor;	// Last entry with time <= the last query
+	static SDUT1			sLoaded[kMaxEntries];
+
+	static inline void		Seek(
+								time32_t				inUTC)
+								{
+									if (inUTC < sTable[sCursor].time ||
+										((sCursor + 1) < sCount &&
+											inUTC >= sTable[sCursor + 1].time))
+									{
+										MoveCursor(inUTC);
+									}
+								}
+	static void				MoveCursor(
+								time32_t				inUTC);
+};
+
+#endif // DUT1Schedule_h
@@ -0,0 +1,353 @@
+/*
+*	DateTimeFormat.h, Copyright Jonathan Mackey 2026
+*
+*	strftime-like date/time formatting where the pattern is parsed at compile
+*	time.  A format is declared with DATE_TIME_FORMAT:
+*
+*		DATE_TIME_FORMAT(DateFormat, "%d-%b-%Y");
+*		char	dateStr[DateFormat::kLength + 1];
+*		DateFormat::Format(time, dateStr);	// e.g. 29-MAR-2023
+*
+*	The pattern is turned into a fixed sequence of writes at known offsets,
+*	one per conversion or literal character.  There is no pattern scanning,
+*	no division by 10 (2 digit values are copied from a 200 byte digit pair
+*	table) and the output length is a compile time constant.
+*
+*	Conversions:
+*		%d	day of month, 01-31			%H	hour, 00-23
+*		%m	month, 01-12				%I	hour, 01-12
+*		%y	year, 00-99					%M	minute, 00-59
+*		%Y	year, 0000-9999				%S	second, 00-60
+*		%b	month, JAN-DEC				%p	AM or PM
+*		%a	day of week, SUN-SAT		%j	day of year, 001-366
+*		%%	a literal %
+*	Any other conversion fails to compile.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef DateTimeFormat_h
+#define DateTimeFormat_h
+
+#include <stddef.h>
+#include <string.h>
+#include <utility>
+#include "UnixTimeConverter.h"
+#include "CivilCalendar.h"
+
+/*
+*	Declares inName as a DateTimeFormat for the string literal inPattern.
+*/
+#define DATE_TIME_FORMAT(inName, inPattern)									\
+	struct inName##Pattern													\
+	{																		\
+		static constexpr const char* Pattern(void) {return(inPattern);}		\
+	};																		\
+	typedef DateTimeFormat<inName##Pattern> inName
+
+/*
+*	The pattern independent part of the formatter.
+*/
+class DateTimeFormatter
+{
+public:
+	struct SFields
+	{
+		SUnixTimeComponents	components;
+		uint16_t	dayOfYear;	// 1 to 366
+		uint8_t		dayOfWeek;	// 0 = Sun, 6 = Sat
+	};
+	enum EField
+	{
+		eLiteral,
+		eDay,
+		eMonth,
+		eYear2,
+		eYear4,
+		eMonthAbbr,
+		eDayOfWeekAbbr,
+		eDayOfYear,
+		eHour24,
+		eHour12,
+		eMinute,
+		eSecond,
+		eAMPM,
+		eInvalid
+	};
+	struct SFormatOp
+	{
+		uint8_t	field;		// EField
+		uint8_t	offset;		// Where the field starts in the output
+		char	literal;	// The character when field is eLiteral
+	};
+	/*
+	*	Writes inValue (0 to 99) as 2 digits.
+	*/
+	static inline void		Write2Digits(
+								uint8_t					inValue,
+								char*					outStr)
+								{memcpy(outStr, &kDigitPairs[inValue*2], 2);}
+	/*
+	*	Writes inValue without leading zeros followed by a nul.  Returns the
+	*	number of digits written.
+	*/
+	static uint8_t			WriteUint16(
+								uint16_t				inValue,
+								char*					outStr);
+
+	static constexpr uint8_t FieldFor(
+								char					inConversion)
+								{
+									return(inConversion == 'd' ? eDay :
+										inConversion == 'm' ? eMonth :
+										inConversion == 'y' ? eYear2 :
+										inConversion == 'Y' ? eYear4 :
+										inConversion == 'b' ? eMonthAbbr :
+										inConversion == 'a' ? eDayOfWeekAbbr :
+										inConversion == 'j' ? eDayOfYear :
+										inConversion == 'H' ? eHour24 :
+										inConversion == 'I' ? eHour12 :
+										inConversion == 'M' ? eMinute :
+										inConversion == 'S' ? eSecond :
+										inConversion == 'p' ? eAMPM :
+										inConversion == '%' ? eLiteral : eInvalid);
+								}
+	static constexpr uint8_t FieldWidth(
+								uint8_t					inField)
+								{
+									return(inField == eYear4 ? 4 :
+										(inField == eMonthAbbr ||
+										 inField == eDayOfWeekAbbr ||
+										 inField == eDayOfYear) ? 3 :
+										inField == eLiteral ? 1 : 2);
+								}
+	/*
+	*	Returns op inIndex of inPattern.  When inIndex is the number of ops
+	*	the returned offset is the length of the output.
+	*/
+	static constexpr SFormatOp OpAt(
+								const char*				inPattern,
+								uint8_t					inIndex)
+								{
+									SFormatOp	op = {eLiteral, 0, 0};
+									for (uint8_t i = 0; inPattern[i]; i++)
+									{
+										op.literal = inPattern[i];
+										op.field = eLiteral;
+										if (op.literal == '%')
+										{
+											// A lone % at the end is an eInvalid op
+											op.field = eInvalid;
+											if (inPattern[i + 1])
+											{
+												op.field = FieldFor(inPattern[++i]);
+											}
+										}
+										if (inIndex == 0)
+										{
+											return(op);
+										}
+										inIndex--;
+										op.offset += FieldWidth(op.field);
+									}
+									op.field = eLiteral;
+									op.literal = 0;
+									return(op);
+								}
+	static constexpr uint8_t OpCount(
+								const char*				inPattern)
+								{
+									uint8_t	count = 0;
+									for (; OpAt(inPattern, count).literal; count++){}
+									return(count);
+								}
+	static constexpr bool	Uses(
+								const char*				inPattern,
+								uint8_t					inField)
+								{
+									bool	uses = false;
+									for (uint8_t i = 0; OpAt(inPattern, i).literal; i++)
+									{
+										uses = uses || OpAt(inPattern, i).field == inField;
+									}
+									return(uses);
+								}
+protected:
+	static const char		kDigitPairs[];	// "000102...99"
+	static const char		kMonthAbbr[];	// "JANFEB...DEC"
+	static const char		kDayOfWeekAbbr[];	// "SUNMON...SAT"
+
+	template <uint8_t TField, uint8_t TOffset, char TLiteral>
+	static inline void		Emit(
+								const SFields&			inFields,
+								char*					outStr)
+								{
+									char*	str = &outStr[TOffset];
+									const SUnixTimeComponents&	c = inFields.components;
+									// TField is a constant so only one case is compiled.
+									switch (TField)
+									{
+										case eLiteral:
+											*str = TLiteral;
+											break;
+										case eDay:
+											Write2Digits(c.day, str);
+											break;
+										case eMonth:
+											Write2Digits(c.month, str);
+											break;
+										case eYear2:
+											Write2Digits(c.year % 100, str);
+											break;
+										case eYear4:
+										{
+											// The width is fixed, so years past 9999 (UnixTime64
+											// reaches 65535) are clamped.
+											uint16_t	year = c.year > 9999 ? 9999 : c.year;
+											Write2Digits(year / 100, str);
+											Write2Digits(year % 100, &str[2]);
+											break;
+										}
+										case eMonthAbbr:
+											memcpy(str, &kMonthAbbr[(c.month-1)*3], 3);
+											break;
+										case eDayOfWeekAbbr:
+											memcpy(str, &kDayOfWeekAbbr[inFields.dayOfWeek*3], 3);
+											break;
+										case eDayOfYear:
+										{
+											uint8_t	hundreds = inFields.dayOfYear >= 300 ? 3 :
+														inFields.dayOfYear >= 200 ? 2 :
+															inFields.dayOfYear >= 100 ? 1 : 0;
+											*str = '0' + hundreds;
+											Write2Digits(inFields.dayOfYear - (hundreds * 100), &str[1]);
+											break;
+										}
+										case eHour24:
+											Write2Digits(c.hour, str);
+											break;
+										case eHour12:
+											Write2Digits(c.hour == 0 ? 12 :
+												(c.hour > 12 ? (c.hour - 12) : c.hour), str);
+											break;
+										case eMinute:
+											Write2Digits(c.minute, str);
+											break;
+										case eSecond:
+											Write2Digits(c.second, str);
+											break;
+										case eAMPM:
+											str[0] = c.hour >= 12 ? 'P' : 'A';
+											str[1] = 'M';
+											break;
+									}
+								}
+};
+
+template <class TPattern>
+class DateTimeFormat : public DateTimeFormatter
+{
+public:
+	/*
+	*	The length of the formatted string, excluding the nul terminator.
+	*/
+	static constexpr uint8_t kOpCount = OpCount(TPattern::Pattern());
+	static constexpr uint8_t kLength = OpAt(TPattern::Pattern(), kOpCount).offset;
+
+	/*
+	*	Formats inFields to outStr, which must hold kLength + 1 characters.
+	*/
+	static inline void		Format(
+								const SFields&			inFields,
+								char*					outStr)
+								{
+									Expand(inFields, outStr,
+										std::make_index_sequence<kOpCount>());
+									outStr[kLength] = 0;
+								}
+	/*
+	*	Formats inTime.  Only the fields used by the pattern are computed.
+	*/
+	template <class TTime>
+	static void				Format(
+								TTime					inTime,
+								char*					outStr)
+								{
+									typedef UnixTimeConverter<TTime>	Converter;
+									SFields	fields;
+									SUnixTimeComponents&	c = fields.components;
+									TTime	secondOfDay = inTime;
+									if (kUsesDate)
+									{
+										secondOfDay = Converter::DateComponents(
+														inTime, c.year, c.month, c.day);
+									}
+									if (kUsesTime)
+									{
+										Converter::TimeComponents(secondOfDay,
+														c.hour, c.minute, c.second);
+									}
+									if (kUsesDayOfWeek)
+									{
+										fields.dayOfWeek = Converter::DayOfWeek(inTime);
+									}
+									if (kUsesDayOfYear)
+									{
+										fields.dayOfYear = CivilCalendar::DayOfYear(
+														c.year, c.month, c.day);
+									}
+									Format(fields, outStr);
+								}
+protected:
+	static constexpr bool	kUsesDayOfYear = Uses(TPattern::Pattern(), eDayOfYear);
+	static constexpr bool	kUsesDayOfWeek = Uses(TPattern::Pattern(), eDayOfWeekAbbr);
+	static constexpr bool	kUsesDate = kUsesDayOfYear ||
+								Uses(TPattern::Pattern(), eDay) ||
+								Uses(TPattern::Pattern(), eMonth) ||
+								Uses(TPattern::Pattern(), eYear2) ||
+								Uses(TPattern::Pattern(), eYear4) ||
+								Uses(TPattern::Pattern(), eMonthAbbr);
+	static constexpr bool	kUsesTime =
+								Uses(TPattern::Pattern(), eHour24) ||
+								Uses(TPattern::Pattern(), eHour12) ||
+								Uses(TPattern::Pattern(), eMinute) ||
+								Uses(TPattern::Pattern(), eSecond) ||
+								Uses(TPattern::Pattern(), eAMPM);
+	static_assert(!Uses(TPattern::Pattern(), eInvalid),
+								"Unsupported conversion in date/time format");
+
+	template <size_t TIndex>
+	struct Op
+	{
+		static constexpr SFormatOp	kOp = OpAt(TPattern::Pattern(), TIndex);
+	};
+	template <size_t... TIndex>
+	static inline void		Expand(
+								const SFields&			inFields,
+								char*					outStr,
+								std::index_sequence<TIndex...>)
+								{
+									int	unused[] = {0, (Emit<Op<TIndex>::kOp.field,
+															Op<TIndex>::kOp.offset,
+															Op<TIndex>::kOp.literal>(
+																inFields, outStr), 0)...};
+									(void)unused;
+								}
+};
+
+#endif // DateTimeFormat_h
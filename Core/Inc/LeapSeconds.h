@@ -0,0 +1,141 @@
+/*
+*	LeapSeconds.h, Copyright Jonathan Mackey 2026
+*
+*	Leap second table with TAI-UTC and upcoming leap second queries.
+*
+*	The built in table is const so it stays in flash.  Each entry is the UTC
+*	Unix time at which a new TAI-UTC value takes effect, i.e. 00:00:00 on the
+*	day following the leap second.  A cursor into the table is kept, so the
+*	per minute queries made while broadcasting are O(1) rather than a search.
+*	The cursor only walks when the time crosses an entry or is set to a
+*	distant time.  Because every query moves the cursor, the table is only
+*	used from one context.  On the STM32 that's the main loop, the RTC ISR
+*	uses the values UnixTimeWWVB::PrepareNextFrame() loads from it.
+*
+*	Host tools can replace the built in table at startup with an IERS/IETF
+*	leap-seconds.list file, e.g. /usr/share/zoneinfo/leap-seconds.list.
+*
+*	Leap seconds can also be added at run time, e.g. to test how receivers
+*	handle one without waiting for the next real one.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef LeapSeconds_h
+#define LeapSeconds_h
+
+#include "UnixTimeConverter.h"
+
+class LeapSeconds
+{
+public:
+	struct SLeapSecond
+	{
+		time32_t	time;			// When taiMinusUTC takes effect
+		int16_t		taiMinusUTC;
+	};
+	/*
+	*	Returns TAI-UTC in seconds at inUTC.  Before 1972 the first value
+	*	(10) is returned.
+	*/
+	static int16_t			TAIMinusUTC(
+								time32_t				inUTC);
+	static inline time32_t	UTCToTAI(
+								time32_t				inUTC)
+								{return(inUTC + TAIMinusUTC(inUTC));}
+	/*
+	*	Returns +1 if a leap second is inserted at the end of the month
+	*	containing inUTC, -1 if one is deleted, otherwise 0.
+	*/
+	static int8_t			LeapSecondAtEOM(
+								time32_t				inUTC);
+	/*
+	*	Returns false if no leap second is scheduled after inUTC.  Otherwise
+	*	outTime is the Unix time at which the new TAI-UTC takes effect (the
+	*	leap second itself precedes it) and outDelta is +1 or -1.
+	*/
+	static bool				NextLeapSecond(
+								time32_t				inUTC,
+								time32_t&				outTime,
+								int8_t&					outDelta);
+	/*
+	*	The time after which the table may be out of date, or 0 if unknown.
+	*/
+	static inline time32_t	Expires(void)
+								{return(sExpires);}
+	/*
+	*	Appends a leap second taking effect at inTime, which must be 00:00:00
+	*	on the first of a month after the last entry.  inDelta is +1 or -1.
+	*	Returns false if inTime isn't valid or the table is full.
+	*/
+	static bool				AddLeapSecond(
+								time32_t				inTime,
+								int8_t					inDelta);
+	/*
+	*	Removes all leap seconds added by AddLeapSecond().
+	*/
+	static void				RemoveAddedLeapSeconds(void);
+	/*
+	*	Parses a sentence of the form "$PLEAP,[+-]1*hh", a request to
+	*	simulate a leap second (see UnixTimeWWVB::SimulateLeapSecond), where
+	*	hh is the NMEA checksum.  Returns false if the sentence isn't valid.
+	*/
+	static bool				ParseSentence(
+								const char*				inSentence,
+								int8_t&					outDelta);
+#if defined __linux__ || defined __MACH__
+	/*
+	*	Replaces the table with the contents of an IERS/IETF leap-seconds.list
+	*	file.  At most kMaxLoadedEntries entries are loaded.  Returns false
+	*	and keeps the current table if the file can't be read or contains no
+	*	entries.
+	*/
+	static bool				LoadIERSList(
+								const char*				inPath);
+	static const uint8_t	kMaxLoadedEntries = 64;
+#else
+	static const uint8_t	kMaxLoadedEntries = 32;
+#endif
+protected:
+	static const SLeapSecond*	sTable;
+	static uint8_t			sCount;
+	static uint8_t			sCursor;	// Last entry with time <= the last query
+	static time32_t			sNextMonthStart;	// Start of the month before entry sCursor+1
+	static time32_t			sExpires;
+	static uint8_t			sAddedCount;	// Entries added by AddLeapSecond()
+	static const SLeapSecond	kLeapSeconds[];
+	static SLeapSecond		sLoaded[kMaxLoadedEntries];
+
+	/*
+	*	Moves the cursor to the last entry at or before inUTC.
+	*/
+	static inline void		Seek(
+								time32_t				inUTC)
+								{
+									if (inUTC < sTable[sCursor].time ||
+										((sCursor + 1) < sCount &&
+											inUTC >= sTable[sCursor + 1].time))
+									{
+										MoveCursor(inUTC);
+									}
+								}
+	static void				MoveCursor(
+								time32_t				inUTC);
+};
+
+#endif // LeapSeconds_h
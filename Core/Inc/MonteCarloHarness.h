@@ -0,0 +1,176 @@
+/*
+*	MonteCarloHarness.h, Copyright Jonathan Mackey 2026
+*
+*	Measures a decoder's time to lock and frame error rate over many
+*	independent trials (Linux and macOS hosts only.)
+*
+*	Each trial starts at a random second between 2001 and 2099, synthesizes
+*	the station's baseband signal (see WWVBSynthesizer), degrades it with a
+*	ChannelModel and feeds it to the decoder under test one second at a
+*	time for a fixed number of whole frames.  A decode is correct when it
+*	names the minute whose frame just ended.
+*
+*	The trials are shared out to worker threads a few at a time and each
+*	thread keeps its own statistics, which are summed at the end.  Every
+*	random value of a trial comes from a generator keyed by the seed and
+*	the trial number, never by the thread, so the results are identical
+*	whatever the number of threads.  Frames are built under a lock because
+*	the encoder reads shared tables (leap seconds, DUT1, the WWVB DST
+*	cache), but that's one short call per trial minute, so the threads
+*	otherwise run independently and the harness scales with the cores.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef MonteCarloHarness_h
+#define MonteCarloHarness_h
+
+#if defined __linux__ || defined __MACH__
+#include <atomic>
+#include <vector>
+#include "TimeCodeStation.h"
+
+/*
+*	A decoder under test.  create returns a decoder for the station and
+*	sample rate, process takes the next inCount baseband I/Q samples and
+*	returns true if a frame was decoded, setting outMinute to the UTC start
+*	of the minute the frame was sent in.
+*/
+struct SDecoderUnderTest
+{
+	const char*	name;
+	void*		(*create)(
+					const STimeCodeStation&	inStation,
+					uint32_t				inSampleRate);
+	void		(*destroy)(
+					void*					inDecoder);
+	bool		(*process)(
+					void*					inDecoder,
+					const float*			inSamples,
+					uint32_t				inCount,
+					time32_t&				outMinute);
+};
+
+class MonteCarloHarness
+{
+public:
+	/*
+	*	The ChannelModel settings of every trial.  A NAN snr is no noise.
+	*/
+	struct SImpairments
+	{
+		float		snr;			// dB
+		float		fadeDepth;		// dB, 0 = none
+		float		fadePeriod;		// s
+		float		burstRate;		// Per s, 0 = none
+		float		burstLength;	// s
+		float		burstLevel;		// dB relative to the carrier
+		float		offset;			// Hz
+		float		jitter;			// s
+	};
+	struct SResults
+	{
+		uint32_t				trials;
+		uint64_t				frames;			// Whole frames sent
+		uint64_t				correct;		// Correct decodes
+		uint64_t				wrong;			// Decodes of the wrong minute
+		uint64_t				lockSeconds;	// Sum over the locked trials
+		/*
+		*	framesToLock[n] is the number of trials whose first correct
+		*	decode was at the end of whole frame n + 1.
+		*/
+		std::vector<uint32_t>	framesToLock;
+
+		void					Merge(
+									const SResults&		inResults);
+		uint32_t				Locked(void) const;
+		/*
+		*	The fewest frames by which inFraction of all trials locked, or 0
+		*	if they didn't.
+		*/
+		uint32_t				FramesToLock(
+									float				inFraction) const;
+		double					MeanFramesToLock(void) const;
+		/*
+		*	Frames not decoded correctly over whole frames sent.
+		*/
+		inline double			FrameErrorRate(void) const
+									{return(frames ? (1.0 - ((double)correct / frames)) : 0);}
+	};
+							MonteCarloHarness(
+								const STimeCodeStation&	inStation,
+								uint32_t				inSampleRate = 1000);
+	/*
+	*	The default is kReferenceDecoder.
+	*/
+	inline void				SetDecoder(
+								const SDecoderUnderTest& inDecoder)
+								{mDecoder = &inDecoder;}
+	inline void				SetFrames(
+								uint32_t				inFrames)
+								{mFrames = inFrames ? inFrames : 1;}
+	/*
+	*	0 (the default) is one thread per core.
+	*/
+	inline void				SetThreads(
+								uint32_t				inThreads)
+								{mThreads = inThreads;}
+	uint32_t				Threads(void) const;
+	/*
+	*	Runs trials inFirstTrial to inFirstTrial + inTrials - 1 of seed inSeed.
+	*/
+	SResults				Run(
+								const SImpairments&		inImpairments,
+								uint64_t				inSeed,
+								uint32_t				inTrials,
+								uint32_t				inFirstTrial = 0);
+	/*
+	*	TimeCodeDecoder.
+	*/
+	static const SDecoderUnderTest	kReferenceDecoder;
+protected:
+	/*
+	*	Shared by the workers of one Run().
+	*/
+	struct SWork
+	{
+		const SImpairments*		impairments;
+		uint64_t				seed;
+		uint32_t				trials;
+		uint32_t				firstTrial;
+		std::atomic<uint32_t>	next;		// Trial index, relative to firstTrial
+	};
+	const STimeCodeStation&	mStation;
+	uint32_t				mSampleRate;
+	const SDecoderUnderTest* mDecoder;
+	uint32_t				mFrames;
+	uint32_t				mThreads;
+
+	void					Worker(
+								SWork*					ioWork,
+								SResults*				outResults);
+	void					RunTrial(
+								const SImpairments&		inImpairments,
+								uint64_t				inSeed,
+								uint32_t				inTrial,
+								std::vector<float>&		ioSamples,
+								SResults&				ioResults);
+};
+#endif
+
+#endif // MonteCarloHarness_h
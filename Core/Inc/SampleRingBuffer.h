@@ -0,0 +1,124 @@
+/*
+*	SampleRingBuffer.h, Copyright Jonathan Mackey 2026
+*
+*	A lock-free single producer, single consumer ring buffer of bytes, used
+*	by host tools to pass samples from the thread generating them to the
+*	thread writing them out.
+*
+*	The capacity is a power of two.  The head and tail are free running
+*	counts of the bytes written and read, so the fill is head - tail and no
+*	byte is wasted to tell full from empty.  Each index is only stored by
+*	its own side, with release ordering, and loaded by the other side with
+*	acquire ordering, so the bytes copied in are visible before the index
+*	that covers them.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef SampleRingBuffer_h
+#define SampleRingBuffer_h
+
+#if defined __linux__ || defined __MACH__
+#include <atomic>
+#include <vector>
+#include <string.h>
+#include <inttypes.h>
+
+class SampleRingBuffer
+{
+public:
+	/*
+	*	inCapacity is rounded up to a power of two bytes.
+	*/
+							SampleRingBuffer(
+								size_t					inCapacity)
+								: mHead(0), mTail(0)
+								{
+									size_t	capacity = 1;
+									while (capacity < inCapacity)
+									{
+										capacity <<= 1;
+									}
+									mData.resize(capacity);
+									mMask = capacity - 1;
+								}
+	inline size_t			Capacity(void) const
+								{return(mMask + 1);}
+	/*
+	*	Bytes that can be read.  Exact for the consumer, a lower bound for
+	*	the producer.
+	*/
+	inline size_t			Available(void) const
+								{return(mHead.load(std::memory_order_acquire) -
+										mTail.load(std::memory_order_acquire));}
+	/*
+	*	Producer only.  Returns the number of bytes written, which is less
+	*	than inBytes when the ring is full.
+	*/
+	inline size_t			Write(
+								const void*				inData,
+								size_t					inBytes)
+								{
+									size_t	head = mHead.load(std::memory_order_relaxed);
+									size_t	space = Capacity() - (head - mTail.load(std::memory_order_acquire));
+									size_t	count = inBytes < space ? inBytes : space;
+									size_t	offset = head & mMask;
+									size_t	first = FirstPart(offset, count);
+									memcpy(&mData[offset], inData, first);
+									memcpy(&mData[0], (const uint8_t*)inData + first, count - first);
+									mHead.store(head + count, std::memory_order_release);
+									return(count);
+								}
+	/*
+	*	Consumer only.  Returns the number of bytes read, which is less than
+	*	inBytes when the ring has fewer.
+	*/
+	inline size_t			Read(
+								void*					outData,
+								size_t					inBytes)
+								{
+									size_t	tail = mTail.load(std::memory_order_relaxed);
+									size_t	available = mHead.load(std::memory_order_acquire) - tail;
+									size_t	count = inBytes < available ? inBytes : available;
+									size_t	offset = tail & mMask;
+									size_t	first = FirstPart(offset, count);
+									memcpy(outData, &mData[offset], first);
+									memcpy((uint8_t*)outData + first, &mData[0], count - first);
+									mTail.store(tail + count, std::memory_order_release);
+									return(count);
+								}
+protected:
+	std::vector<uint8_t>	mData;
+	size_t					mMask;
+	alignas(64) std::atomic<size_t>	mHead;	// Bytes written, stored by the producer
+	alignas(64) std::atomic<size_t>	mTail;	// Bytes read, stored by the consumer
+
+	/*
+	*	The part of inCount bytes at inOffset before the end of the ring.
+	*/
+	inline size_t			FirstPart(
+								size_t					inOffset,
+								size_t					inCount) const
+								{
+									size_t	first = Capacity() - inOffset;
+									return(first < inCount ? first : inCount);
+								}
+};
+#endif
+
+#endif // SampleRingBuffer_h
@@ -0,0 +1,136 @@
+/*
+*	SequenceLock.h, Copyright Jonathan Mackey 2026
+*
+*	A sequence lock (seqlock) for data written by one writer at a time and
+*	read by any number of readers without blocking the writer.
+*
+*	The writer makes the sequence odd before changing the data and even again
+*	after.  A reader notes the sequence before reading the data and retries
+*	if the sequence was odd or has changed by the time it's done reading.
+*
+*	On the STM32 the writers are ISRs and the readers are the main loop, so
+*	a read either completes before a writer ISR or has the ISR occur within
+*	it and is retried.  Do not read from an ISR that can preempt a writer
+*	ISR, it would spin forever on the odd sequence.  The data memory barrier
+*	(__DMB) keeps the accesses in program order.
+*
+*	On hosts std::atomic with acquire/release ordering is used.  Multiple
+*	writer threads must be serialized by the caller.  A reader thread may
+*	read the data while the writer changes it, which is a data race unless
+*	both access it atomically, so the guarded data (scalars only) is read
+*	with Load() and written with Store(), relaxed atomic accesses on hosts
+*	and plain ones on the STM32.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef SequenceLock_h
+#define SequenceLock_h
+
+#include <inttypes.h>
+#if defined STM32_CUBE_ && !defined __linux__ && !defined __MACH__
+#include "stm32f1xx_hal.h"
+#define SEQUENCE_LOCK_DMB	1
+#else
+#include <atomic>
+#endif
+
+class SequenceLock
+{
+public:
+#ifdef SEQUENCE_LOCK_DMB
+							SequenceLock(void)
+								: mSequence(0){}
+	inline void				WriteBegin(void)
+								{
+									mSequence = mSequence + 1;
+									__DMB();
+								}
+	inline void				WriteEnd(void)
+								{
+									__DMB();
+									mSequence = mSequence + 1;
+								}
+	inline uint32_t			ReadBegin(void) const
+								{
+									uint32_t	sequence;
+									while ((sequence = mSequence) & 1){}
+									__DMB();
+									return(sequence);
+								}
+	/*
+	*	Returns true if the data read since ReadBegin may be torn.
+	*/
+	inline bool				ReadRetry(
+								uint32_t				inSequence) const
+								{
+									__DMB();
+									return(mSequence != inSequence);
+								}
+	template <class T>
+	static inline T			Load(
+								const T&				inData)
+								{return(inData);}
+	template <class T>
+	static inline void		Store(
+								T&						outData,
+								T						inValue)
+								{outData = inValue;}
+protected:
+	volatile uint32_t		mSequence;
+#else
+							SequenceLock(void)
+								: mSequence(0){}
+	inline void				WriteBegin(void)
+								{
+									mSequence.store(mSequence.load(std::memory_order_relaxed) + 1,
+														std::memory_order_relaxed);
+									std::atomic_thread_fence(std::memory_order_release);
+								}
+	inline void				WriteEnd(void)
+								{
+									mSequence.store(mSequence.load(std::memory_order_relaxed) + 1,
+														std::memory_order_release);
+								}
+	inline uint32_t			ReadBegin(void) const
+								{
+									uint32_t	sequence;
+									while ((sequence = mSequence.load(std::memory_order_acquire)) & 1){}
+									return(sequence);
+								}
+	inline bool				ReadRetry(
+								uint32_t				inSequence) const
+								{
+									std::atomic_thread_fence(std::memory_order_acquire);
+									return(mSequence.load(std::memory_order_relaxed) != inSequence);
+								}
+	template <class T>
+	static inline T			Load(
+								const T&				inData)
+								{return(__atomic_load_n(&inData, __ATOMIC_RELAXED));}
+	template <class T>
+	static inline void		Store(
+								T&						outData,
+								T						inValue)
+								{__atomic_store_n(&outData, inValue, __ATOMIC_RELAXED);}
+protected:
+	std::atomic<uint32_t>	mSequence;
+#endif
+};
+
+#endif // SequenceLock_h
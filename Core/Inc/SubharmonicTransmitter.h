@@ -0,0 +1,139 @@
+/*
+*	SubharmonicTransmitter.h, Copyright Jonathan Mackey 2026
+*
+*	Sends the WWVB time code through a sound card, for clocks that are out
+*	of reach of the STM32 board (Linux and macOS hosts only.)
+*
+*	A sound card can't produce 60 kHz, but a 20 kHz square wave's third
+*	harmonic is 60 kHz, and the amplitude and phase modulation carry over
+*	to it (see WWVBSynthesizer::eSubharmonicS16.)  A clock placed near the
+*	speaker or headphones receives the harmonic.
+*
+*	The synthesizer runs on the calling thread and writes into a
+*	SampleRingBuffer.  A second thread drains the ring to the sink, by
+*	default a raw 16 bit PCM file or pipe (e.g. stdout piped to aplay), so
+*	it can be tested without audio hardware.  The sink is a SampleSink
+*	function, so any audio API can be plugged in.
+*
+*	The stream starts on a whole second of the host clock.  When paced (the
+*	default), each block is passed to the sink at its due time on the host
+*	clock less the lead, and the ring only holds the buffer length of
+*	samples ahead of the sink.  Blocks are a hundredth of a second, so every
+*	second edge starts a block.  The time each edge is actually passed to
+*	the sink, relative to when it's due, is measured (see Latency().)  Any
+*	fixed output latency of the sink itself can be offset with the lead.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef SubharmonicTransmitter_h
+#define SubharmonicTransmitter_h
+
+#if defined __linux__ || defined __MACH__
+#include <atomic>
+#include <chrono>
+#include "WWVBSynthesizer.h"
+#include "SampleRingBuffer.h"
+
+class SubharmonicTransmitter
+{
+public:
+	/*
+	*	Times in microseconds that second edges were passed to the sink,
+	*	relative to their due time on the host clock.  Negative is early.
+	*/
+	struct SLatency
+	{
+		uint32_t	edges;		// Edges measured
+		int32_t		minimum;
+		int32_t		maximum;
+		int64_t		total;
+		uint32_t	underruns;	// Blocks that weren't ready when due
+		inline int32_t	Mean(void) const
+							{return(edges ? (int32_t)(total / edges) : 0);}
+	};
+	/*
+	*	inSampleRate must be a multiple of 100, e.g. 48000, 96000 or 192000.
+	*	The tone is a third of inCarrierHz.  inBufferMs is the ring length.
+	*/
+							SubharmonicTransmitter(
+								uint32_t				inSampleRate,
+								uint32_t				inCarrierHz = 60000,
+								uint32_t				inBufferMs = 200);
+	inline bool				Valid(void) const
+								{return(mSynthesizer.Valid() &&
+										(mSynthesizer.SampleRate() % 100) == 0);}
+	/*
+	*	The synthesizer, e.g. to set its amplitude.  Its sink is the ring.
+	*/
+	inline WWVBSynthesizer&	Synthesizer(void)
+								{return(mSynthesizer);}
+	/*
+	*	Sets the sink the ring is drained to (default FileSink to stdout.)
+	*/
+	void					SetSink(
+								SampleSink				inSink,
+								void*					inContext);
+	/*
+	*	How long before its due time a block is passed to the sink (default
+	*	0), e.g. the sink's own output latency.
+	*/
+	inline void				SetLead(
+								uint32_t				inMicroseconds)
+								{mLead = inMicroseconds;}
+	/*
+	*	When inPaced is false the blocks are passed to the sink as fast as
+	*	possible, e.g. to write a file.  The latency is then meaningless.
+	*/
+	inline void				SetPaced(
+								bool					inPaced)
+								{mPaced = inPaced;}
+	/*
+	*	Sends inSeconds seconds starting at the next whole second of the
+	*	host clock.  Returns false if the sink failed.
+	*/
+	bool					Run(
+								uint32_t				inSeconds,
+								bool					inPhaseModulation);
+	inline time32_t			StartTime(void) const
+								{return(mStartTime);}
+	inline const SLatency&	Latency(void) const
+								{return(mLatency);}
+protected:
+	typedef std::chrono::steady_clock	Clock;
+	WWVBSynthesizer			mSynthesizer;
+	SampleRingBuffer		mRing;
+	SampleSink				mSink;
+	void*					mSinkContext;
+	uint32_t				mLead;
+	bool					mPaced;
+	time32_t				mStartTime;
+	Clock::time_point		mStartPoint;	// mStartTime on the steady clock
+	std::atomic<bool>		mProducerDone;
+	std::atomic<bool>		mSinkFailed;
+	SLatency				mLatency;
+
+	static bool				RingSink(
+								void*					inContext,
+								const void*				inData,
+								size_t					inBytes);
+	void					Drain(void);
+};
+#endif
+
+#endif // SubharmonicTransmitter_h
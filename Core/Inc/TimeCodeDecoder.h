@@ -0,0 +1,87 @@
+/*
+*	TimeCodeDecoder.h, Copyright Jonathan Mackey 2026
+*
+*	A reference receiver for any station described by a TimeCodeStation
+*	descriptor, decoding the baseband I/Q output of WWVBSynthesizer (Linux
+*	and macOS hosts only.)  It's the default decoder of MonteCarloHarness,
+*	a baseline for the receivers' own algorithms.
+*
+*	The decoder is given second sync, i.e. the stream starts on a second
+*	edge, and finds the frame and the time from the carrier alone.  The
+*	mean magnitude of each tenth is sliced halfway between running
+*	estimates of the full and reduced carrier levels, and each second is
+*	the symbol whose carrier pattern is nearest.  After every second the
+*	last 60 symbols are tried as a frame ending in second 59: the bits that
+*	never change, every parity bit and every field's digits must be valid
+*	before the time is accepted.  The frame is the inverse of
+*	TimeCodeEncoder, so this never decodes a frame with a detected error,
+*	but it has no knowledge of preceding minutes to catch undetected ones.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef TimeCodeDecoder_h
+#define TimeCodeDecoder_h
+
+#if defined __linux__ || defined __MACH__
+#include "TimeCodeStation.h"
+#include "TimeZoneRule.h"
+
+class TimeCodeDecoder
+{
+public:
+							TimeCodeDecoder(
+								const STimeCodeStation&	inStation,
+								uint32_t				inSampleRate);
+	/*
+	*	Takes the next inCount baseband I/Q samples (2 floats each.)  Returns
+	*	true if a frame was decoded, setting outMinute to the UTC start of
+	*	the minute it was sent in.  At most one frame is decoded per call.
+	*/
+	bool					Process(
+								const float*			inSamples,
+								uint32_t				inCount,
+								time32_t&				outMinute);
+	/*
+	*	The symbols of the last 60 seconds, the newest in bit 59.
+	*/
+	inline const STimeCodeFrame& Symbols(void) const
+								{return(mSymbols);}
+protected:
+	const STimeCodeStation&	mStation;
+	TimeZoneRule			mRule;
+	uint32_t				mTenthSamples;
+	uint32_t				mSampleCount;	// In the current tenth
+	float					mSum;			// Of the current tenth's magnitudes
+	float					mTenths[10];	// Mean magnitudes
+	uint32_t				mTenth;
+	float					mFull;			// Estimated carrier levels
+	float					mReduced;
+	STimeCodeFrame			mSymbols;
+	uint64_t				mMarks;			// Seconds sent as markPattern
+	uint64_t				mDataA;			// Bits set by fields or parity
+	uint64_t				mDataB;
+	uint32_t				mSeconds;		// Received, saturates at 60
+
+	void					EndSecond(void);
+	bool					Decode(
+								time32_t&				outMinute);
+};
+#endif
+
+#endif // TimeCodeDecoder_h
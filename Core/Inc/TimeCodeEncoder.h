@@ -0,0 +1,80 @@
+/*
+*	TimeCodeEncoder.h, Copyright Jonathan Mackey 2026
+*
+*	Builds the frames of any station described by a TimeCodeStation
+*	descriptor.
+*
+*	The source values are derived once per minute, in the station's time
+*	zone, for the minute the frame describes.  Each field is then written
+*	into its bitplane and the parity bits are computed from the result.
+*	The descriptor is only read, so one encoder serves every station.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef TimeCodeEncoder_h
+#define TimeCodeEncoder_h
+
+#include "TimeCodeStation.h"
+#include "TimeZoneRule.h"
+
+class TimeCodeEncoder
+{
+public:
+							TimeCodeEncoder(
+								const STimeCodeStation&	inStation);
+	/*
+	*	Returns the frame sent during the minute containing inTime (UTC.)
+	*/
+	const STimeCodeFrame&	Encode(
+								time32_t				inTime);
+	/*
+	*	Rebuilds the frame for the minute containing inTime.
+	*/
+	void					Rebuild(
+								time32_t				inTime);
+	/*
+	*	Forces the next Encode() to rebuild, e.g. after a table used to build
+	*	the frame changes.
+	*/
+	inline void				Invalidate(void)
+								{mTime = 0;}
+	inline const STimeCodeFrame& Frame(void) const
+								{return(mFrame);}
+	inline const STimeCodeStation& Station(void) const
+								{return(mStation);}
+	inline TimeZoneRule&	Rule(void)
+								{return(mRule);}
+	/*
+	*	Returns the bits of inValue in inFormat, not yet positioned.
+	*/
+	static uint32_t			FormatValue(
+								uint32_t				inValue,
+								uint8_t					inFormat);
+protected:
+	const STimeCodeStation&	mStation;
+	TimeZoneRule			mRule;
+	STimeCodeFrame			mFrame;
+	time32_t				mTime;		// 0 = no frame yet
+
+	void					LoadSources(
+								time32_t				inTime,
+								uint16_t*				outValues);
+};
+
+#endif // TimeCodeEncoder_h
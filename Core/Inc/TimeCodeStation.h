@@ -0,0 +1,283 @@
+/*
+*	TimeCodeStation.h, Copyright Jonathan Mackey 2026
+*
+*	Compile time frame descriptors for the WWVB, DCF77, MSF and JJY time
+*	code stations.
+*
+*	A frame is two bitplanes, bit n being second n.  For MSF these are the
+*	A and B bits.  For the other stations A is the data bit, and a B bit
+*	marks a position marker (WWVB and JJY) or the second 59 gap (DCF77.)
+*	The two bits of a second form its symbol, 0 to 3.
+*
+*	A descriptor lists each field's source value, format, first second
+*	and width, plus the parity bits and the bits that never change.  It
+*	also gives each symbol's carrier pattern: bit n set means the carrier
+*	is reduced during tenth n of the second.  Markers that depend only on
+*	the second, such as the MSF minute marker, replace the symbol's
+*	pattern via markSeconds.  One encoder handles every station (see
+*	TimeCodeEncoder), and the per second code only needs Pattern(), a
+*	table lookup.  There is no virtual dispatch anywhere.
+*
+*	Not yet supported: leap second minutes (a 61 or 59 second frame) for
+*	stations other than WWVB, and the JJY call sign minutes (15 and 45.)
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef TimeCodeStation_h
+#define TimeCodeStation_h
+
+#include "UnixTimeConverter.h"
+
+struct STimeCodeFrame
+{
+	uint64_t	a;
+	uint64_t	b;
+	/*
+	*	Returns (B << 1) | A for inSecond, 0 to 63.
+	*/
+	inline uint32_t			GetSymbol(
+								uint32_t				inSecond) const
+								{
+									return((uint32_t)((((b >> inSecond) & 1) << 1) |
+													((a >> inSecond) & 1)));
+								}
+};
+
+/*
+*	The values a field can be derived from.  The date and time are those
+*	of the station's time zone for the minute the frame describes.
+*/
+enum ETimeCodeSource
+{
+	eTCS_Minute,
+	eTCS_Hour,
+	eTCS_Day,				// Of the month
+	eTCS_Month,
+	eTCS_Year,				// 0 to 99
+	eTCS_DayOfYear,
+	eTCS_DayOfWeek,			// 0 = Sun, 6 = Sat
+	eTCS_DayOfWeekISO,		// 1 = Mon, 7 = Sun
+	eTCS_DST,				// 1 = DST in effect
+	eTCS_StandardTime,		// 1 = DST not in effect
+	eTCS_DSTChange,			// 1 = DST starts or ends within the hour
+	eTCS_WWVBDST,			// UnixTimeWWVB::eDST of the UTC day
+	eTCS_LeapYear,
+	eTCS_LeapSecondMonth,	// 1 = a leap second at the end of the UTC month
+	eTCS_LeapSecondHour,	// 1 = a leap second within the hour
+	eTCS_JJYLeapSecond,		// 3 = positive, 2 = negative this month, 0 = none
+	eTCS_WWVBDUT1Sign,		// 5 = positive, 2 = negative
+	eTCS_DUT1,				// Tenths, magnitude
+	eTCS_DUT1Positive,		// Tenths if positive, else 0
+	eTCS_DUT1Negative,		// Tenths if negative, else 0
+	eTCS_SourceCount
+};
+
+enum ETimeCodeFormat
+{
+	eTCF_Binary,
+	eTCF_BCD,				// All digits
+	eTCF_Units,				// Single BCD digits
+	eTCF_Tens,
+	eTCF_Hundreds,
+	eTCF_Unary,				// value 1 bits, e.g. MSF DUT1
+	eTCF_FormatMask	= 0x0F,
+	eTCF_LSBFirst	= 0x10,	// Default is most significant bit first
+	eTCF_PlaneB		= 0x20	// Default is the A plane
+};
+
+struct STimeCodeField
+{
+	uint8_t	source;			// ETimeCodeSource
+	uint8_t	format;			// ETimeCodeFormat and flags
+	uint8_t	firstSecond;
+	uint8_t	width;			// Bits
+};
+
+/*
+*	The parity bit at second is the parity of the A bits in coverage.
+*/
+struct STimeCodeParity
+{
+	uint64_t	coverage;
+	uint8_t		second;
+	uint8_t		flags;		// eTCF_PlaneB, eOddParity
+};
+
+struct STimeCodeStation
+{
+	const char*				name;
+	const char*				timeZone;		// POSIX TZ string of the time sent
+	uint32_t				carrierHz;
+	uint8_t					minuteOffset;	// 1 = the frame describes the next minute
+	uint16_t				patterns[4];	// Per symbol, bit n = reduced in tenth n
+	uint64_t				markSeconds;	// Seconds sent as markPattern
+	uint16_t				markPattern;
+	uint64_t				constantA;		// Bits set in every frame
+	uint64_t				constantB;
+	const STimeCodeField*	fields;
+	uint8_t					fieldCount;
+	const STimeCodeParity*	parities;
+	uint8_t					parityCount;
+
+	/*
+	*	Returns the carrier pattern of second inSecond given its symbol.
+	*/
+	inline constexpr uint16_t Pattern(
+								uint32_t				inSymbol,
+								uint32_t				inSecond) const
+								{
+									return(((markSeconds >> inSecond) & 1) ?
+											markPattern : patterns[inSymbol]);
+								}
+};
+
+class TimeCodeStation
+{
+public:
+	enum
+	{
+		eOddParity	= 0x01	// STimeCodeParity::flags, default is even
+	};
+	static constexpr STimeCodeField		kWWVBFields[] =
+	{
+		{eTCS_Minute,		eTCF_Tens,		1,	3},
+		{eTCS_Minute,		eTCF_Units,		5,	4},
+		{eTCS_Hour,			eTCF_Tens,		12,	2},
+		{eTCS_Hour,			eTCF_Units,		15,	4},
+		{eTCS_DayOfYear,	eTCF_Hundreds,	22,	2},
+		{eTCS_DayOfYear,	eTCF_Tens,		25,	4},
+		{eTCS_DayOfYear,	eTCF_Units,		30,	4},
+		{eTCS_WWVBDUT1Sign,	eTCF_Binary,	36,	3},
+		{eTCS_DUT1,			eTCF_Binary,	40,	4},
+		{eTCS_Year,			eTCF_Tens,		45,	4},
+		{eTCS_Year,			eTCF_Units,		50,	4},
+		{eTCS_LeapYear,		eTCF_Binary,	55,	1},
+		{eTCS_LeapSecondMonth, eTCF_Binary,	56,	1},
+		{eTCS_WWVBDST,		eTCF_Binary,	57,	2}
+	};
+	static constexpr STimeCodeStation	kWWVB =
+	{
+		"WWVB", "UTC0", 60000, 0,
+		{0x003, 0x01F, 0x0FF, 0x0FF},	// 0.2s, 0.5s, 0.8s reduced
+		0, 0,
+		0, 0x0802008020080201ULL,		// Markers
+		kWWVBFields, sizeof(kWWVBFields)/sizeof(STimeCodeField),
+		nullptr, 0
+	};
+
+	static constexpr STimeCodeField		kDCF77Fields[] =
+	{
+		{eTCS_DSTChange,	eTCF_Binary,	16,	1},	// A1
+		{eTCS_DST,			eTCF_Binary,	17,	1},	// Z1
+		{eTCS_StandardTime,	eTCF_Binary,	18,	1},	// Z2
+		{eTCS_LeapSecondHour, eTCF_Binary,	19,	1},	// A2
+		{eTCS_Minute,		eTCF_BCD | eTCF_LSBFirst,	21,	7},
+		{eTCS_Hour,			eTCF_BCD | eTCF_LSBFirst,	29,	6},
+		{eTCS_Day,			eTCF_BCD | eTCF_LSBFirst,	36,	6},
+		{eTCS_DayOfWeekISO,	eTCF_Binary | eTCF_LSBFirst, 42, 3},
+		{eTCS_Month,		eTCF_BCD | eTCF_LSBFirst,	45,	5},
+		{eTCS_Year,			eTCF_BCD | eTCF_LSBFirst,	50,	8}
+	};
+	static constexpr STimeCodeParity	kDCF77Parities[] =
+	{
+		{0x7FULL << 21, 28, 0},		// P1, minute
+		{0x3FULL << 29, 35, 0},		// P2, hour
+		{0x3FFFFFULL << 36, 58, 0}	// P3, date
+	};
+	static constexpr STimeCodeStation	kDCF77 =
+	{
+		"DCF77", "CET-1CEST,M3.5.0,M10.5.0/3", 77500, 1,
+		{0x001, 0x003, 0x000, 0x000},	// 0.1s, 0.2s reduced, second 59 not
+		0, 0,
+		1ULL << 20, 1ULL << 59,			// S (start of time), second 59 gap
+		kDCF77Fields, sizeof(kDCF77Fields)/sizeof(STimeCodeField),
+		kDCF77Parities, sizeof(kDCF77Parities)/sizeof(STimeCodeParity)
+	};
+
+	static constexpr STimeCodeField		kMSFFields[] =
+	{
+		{eTCS_DUT1Positive,	eTCF_Unary | eTCF_PlaneB | eTCF_LSBFirst, 1, 8},
+		{eTCS_DUT1Negative,	eTCF_Unary | eTCF_PlaneB | eTCF_LSBFirst, 9, 8},
+		{eTCS_Year,			eTCF_BCD,		17,	8},
+		{eTCS_Month,		eTCF_BCD,		25,	5},
+		{eTCS_Day,			eTCF_BCD,		30,	6},
+		{eTCS_DayOfWeek,	eTCF_Binary,	36,	3},
+		{eTCS_Hour,			eTCF_BCD,		39,	6},
+		{eTCS_Minute,		eTCF_BCD,		45,	7},
+		{eTCS_DSTChange,	eTCF_Binary | eTCF_PlaneB, 53, 1},
+		{eTCS_DST,			eTCF_Binary | eTCF_PlaneB, 58, 1}
+	};
+	static constexpr STimeCodeParity	kMSFParities[] =
+	{
+		{0xFFULL << 17, 54, eTCF_PlaneB | eOddParity},	// Year
+		{0x7FFULL << 25, 55, eTCF_PlaneB | eOddParity},	// Month and day
+		{0x7ULL << 36, 56, eTCF_PlaneB | eOddParity},	// Day of week
+		{0x1FFFULL << 39, 57, eTCF_PlaneB | eOddParity}	// Hour and minute
+	};
+	static constexpr STimeCodeStation	kMSF =
+	{
+		"MSF", "GMT0BST,M3.5.0/1,M10.5.0", 60000, 1,
+		{0x001, 0x003, 0x005, 0x007},	// 00, A, B, AB
+		1, 0x01F,						// 0.5s minute marker
+		0x3FULL << 53, 0,				// Minute identifier 01111110
+		kMSFFields, sizeof(kMSFFields)/sizeof(STimeCodeField),
+		kMSFParities, sizeof(kMSFParities)/sizeof(STimeCodeParity)
+	};
+
+	static constexpr STimeCodeField		kJJYFields[] =
+	{
+		{eTCS_Minute,		eTCF_Tens,		1,	3},
+		{eTCS_Minute,		eTCF_Units,		5,	4},
+		{eTCS_Hour,			eTCF_Tens,		12,	2},
+		{eTCS_Hour,			eTCF_Units,		15,	4},
+		{eTCS_DayOfYear,	eTCF_Hundreds,	22,	2},
+		{eTCS_DayOfYear,	eTCF_Tens,		25,	4},
+		{eTCS_DayOfYear,	eTCF_Units,		30,	4},
+		{eTCS_Year,			eTCF_BCD,		41,	8},
+		{eTCS_DayOfWeek,	eTCF_Binary,	50,	3},
+		{eTCS_JJYLeapSecond, eTCF_Binary,	53,	2}
+	};
+	static constexpr STimeCodeParity	kJJYParities[] =
+	{
+		{0x7FULL << 12, 36, 0},		// PA1, hour
+		{0xFFULL << 1, 37, 0}		// PA2, minute
+	};
+	/*
+	*	JJY's levels are inverted: the carrier is at full power first and
+	*	reduced for the rest of the second.
+	*/
+	static constexpr STimeCodeStation	kJJY =
+	{
+		"JJY", "JST-9", 40000, 0,
+		{0x300, 0x3E0, 0x3FC, 0x3FC},	// 0.8s, 0.5s, 0.2s full
+		0, 0,
+		0, 0x0802008020080201ULL,		// Markers
+		kJJYFields, sizeof(kJJYFields)/sizeof(STimeCodeField),
+		kJJYParities, sizeof(kJJYParities)/sizeof(STimeCodeParity)
+	};
+	static const STimeCodeStation* const	kStations[];
+	static const uint8_t	kStationCount = 4;
+	/*
+	*	Returns the station named inName (case sensitive), or nullptr.
+	*/
+	static const STimeCodeStation* Find(
+								const char*				inName);
+};
+
+#endif // TimeCodeStation_h
@@ -0,0 +1,167 @@
+/*
+*	TimeZoneRule.h, Copyright Jonathan Mackey 2026
+*
+*	Local time from a POSIX TZ string such as "EST5EDT,M3.2.0,M11.1.0" or
+*	"AEST-10AEDT,M10.1.0,M4.1.0/3".
+*
+*	The string is parsed once.  The two DST transition instants are then
+*	computed for one year at a time and cached, so converting between UTC and
+*	local time is normally two comparisons and an add.  The transitions are
+*	only recomputed when a time in a different year is converted.
+*
+*	Supported:
+*		std offset [dst [offset] [,start[/time],end[/time]]]
+*		Names are alphabetic (e.g. EST) or quoted (e.g. <+0530>.)
+*		Offsets are [+-]hh[:mm[:ss]], positive west of Greenwich as per POSIX.
+*		Rules are Jn (1-365, Feb 29 never counted), n (0-365) or Mm.w.d.
+*		Rule times may be -167 to 167 hours (the RFC 8536 extension.)
+*	When a dst name is given without rules, the US rules M3.2.0,M11.1.0 are
+*	used.
+*
+*	No heap allocation is used.  Names are truncated to kMaxNameLen characters.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef TimeZoneRule_h
+#define TimeZoneRule_h
+
+#include "UnixTimeConverter.h"
+
+class TimeZoneRule
+{
+public:
+							TimeZoneRule(void);	// UTC, no DST
+	/*
+	*	Returns false if inTZString isn't a valid POSIX TZ string, in which
+	*	case the rule is set to UTC.
+	*/
+	bool					Parse(
+								const char*				inTZString);
+#ifdef __linux__
+	/*
+	*	Parses the TZ environment variable or, when TZ isn't set or isn't a
+	*	POSIX TZ string, the POSIX TZ footer of /etc/localtime.  Returns false
+	*	if neither could be parsed (the rule is then UTC.)
+	*/
+	bool					ParseSystemTimeZone(void);
+#endif
+	inline bool				HasDST(void) const
+								{return(mHasDST);}
+	/*
+	*	Offsets in seconds east of UTC, i.e. local = UTC + offset.
+	*/
+	inline int32_t			StandardOffset(void) const
+								{return(mStdOffset);}
+	inline int32_t			DSTOffset(void) const
+								{return(mDSTOffset);}
+	inline const char*		StandardName(void) const
+								{return(mStdName);}
+	inline const char*		DSTName(void) const
+								{return(mDSTName);}
+	inline bool				IsDST(
+								time32_t				inUTC)
+								{
+									LoadYearOf(inUTC);
+									return((inUTC >= mRangeStart &&
+										inUTC < mRangeEnd) == mRangeIsDST);
+								}
+	inline time32_t			UTCToLocal(
+								time32_t				inUTC)
+								{return(inUTC + (IsDST(inUTC) ? mDSTOffset : mStdOffset));}
+	/*
+	*	A local time that occurs twice when DST ends is taken as DST (the
+	*	earlier instant.)  A local time skipped when DST begins is taken as
+	*	standard time.
+	*/
+	time32_t				LocalToUTC(
+								time32_t				inLocal);
+	/*
+	*	Returns the UTC instants DST starts and ends in inYear.  In the
+	*	southern hemisphere the end precedes the start.  Returns false if
+	*	there is no DST.
+	*/
+	bool					Transitions(
+								uint16_t				inYear,
+								time64_t&				outDSTStart,
+								time64_t&				outDSTEnd);
+	static const uint8_t	kMaxNameLen = 7;
+protected:
+	enum ERuleType
+	{
+		eJulian1,		// Jn, 1 to 365, Feb 29 is never counted
+		eJulian0,		// n, 0 to 365, Feb 29 is counted in leap years
+		eMonthWeekDay	// Mm.w.d
+	};
+	struct SRule
+	{
+		int32_t		time;		// Local seconds after midnight, may be negative
+		uint16_t	day;		// Jn or n
+		uint8_t		type;		// ERuleType
+		uint8_t		month;		// 1 to 12
+		uint8_t		week;		// 1 to 5, 5 = last
+		uint8_t		dayOfWeek;	// 0 = Sun
+	};
+	SRule					mStart;
+	SRule					mEnd;
+	int32_t					mStdOffset;
+	int32_t					mDSTOffset;
+	/*
+	*	The cached year is [mYearStart, mYearEnd) in UTC.  Within it, DST is
+	*	in effect when a time is in [mRangeStart, mRangeEnd) == mRangeIsDST.
+	*	In the northern hemisphere the range is [DST start, DST end), in the
+	*	southern hemisphere it's [DST end, DST start), i.e. standard time.
+	*/
+	time64_t				mYearStart;
+	time64_t				mYearEnd;
+	time64_t				mRangeStart;
+	time64_t				mRangeEnd;
+	bool					mRangeIsDST;
+	bool					mHasDST;
+	char					mStdName[kMaxNameLen+1];
+	char					mDSTName[kMaxNameLen+1];
+
+	void					LoadYear(
+								uint16_t				inYear);
+	inline void				LoadYearOf(
+								time64_t				inTime)
+								{
+									if (inTime < mYearStart || inTime >= mYearEnd)
+									{
+										uint16_t	year;
+										uint8_t		month, day;
+										UnixTime64::DateComponents(inTime, year, month, day);
+										LoadYear(year);
+									}
+								}
+	static time64_t			RuleDays(
+								const SRule&			inRule,
+								uint16_t				inYear);
+	static const char*		ParseName(
+								const char*				inStr,
+								char*					outName);
+	static const char*		ParseTime(
+								const char*				inStr,
+								uint8_t					inMaxHours,
+								int32_t&				outSeconds);
+	static const char*		ParseRule(
+								const char*				inStr,
+								SRule&					outRule);
+};
+
+#endif // TimeZoneRule_h
@@ -0,0 +1,140 @@
+/*
+*	TimestampParser.h, Copyright Jonathan Mackey 2026
+*
+*	Parses date/time strings in any of the following formats to Unix time:
+*
+*	CCLK	YY/MM/DD,hh:mm:ss[+-uu]
+*			Cell modem AT+CCLK local time.  +-uu is the local timezone in
+*			quarter hours.
+*	PSUTTZ	YY/MM/DD,hh:mm:ss","+-uu",DST
+*			Cell modem *PSUTTZ UTC time.  +-uu as above, DST is ignored.
+*	Month	Mmm-DD-YYYY hh:mm:ss
+*			Mmm is a 3 letter English month abbreviation in any case.
+*	ISO		YYYY-MM-DDThh:mm:ss[.fff][Z|+-hh[[:]mm]]
+*			ISO 8601 extended format.  A space may be used in place of the T.
+*			The fraction of a second, if any, is ignored.
+*
+*	Rather than parsing two characters at a time, each string is loaded
+*	8 bytes at a time into a uint64_t and all of the digits in those 8 bytes
+*	are validated and converted to 2 digit values with a handful of 64 bit
+*	operations (SWAR, SIMD within a register.)  No byte is ever read beyond
+*	the end of the string or line being parsed.
+*
+*	This assumes a little endian target (the STM32 and x86 are.)
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef TimestampParser_h
+#define TimestampParser_h
+
+#include <stddef.h>
+#include "UnixTimeConverter.h"
+
+class TimestampParser
+{
+public:
+	enum EFormat
+	{
+		eFormat_Unknown,
+		eFormat_CCLK,
+		eFormat_PSUTTZ,
+		eFormat_Month,
+		eFormat_ISO8601
+	};
+	/*
+	*	time is the time as written.  offset is the timezone, if any, in
+	*	seconds east of UTC.  For PSUTTZ the time as written is UTC, for the
+	*	other formats it's local time.
+	*/
+	struct STimestamp
+	{
+		time32_t	time;
+		int32_t		offset;
+		uint8_t		format;	// EFormat
+		bool		timeIsUTC;
+		inline time32_t	UTC(void) const
+							{return(timeIsUTC ? time : (time - offset));}
+		inline time32_t	Local(void) const
+							{return(timeIsUTC ? (time + offset) : time);}
+	};
+	/*
+	*	Parses the first inLength characters of inString.  Characters
+	*	following a valid timestamp are ignored.  Returns false if the
+	*	format isn't recognized or any field is out of range.
+	*/
+	static bool				Parse(
+								const char*				inString,
+								size_t					inLength,
+								STimestamp&				outTimestamp);
+	/*
+	*	Parses a date of the form Mmm-DD-YYYY and a time of the form hh:mm:ss
+	*	passed as separate strings.  Returns zero if either is invalid.
+	*/
+	static time32_t			ParseMonthDateAndTime(
+								const char*				inDateStr,
+								const char*				inTimeStr);
+	/*
+	*	Parses a buffer of newline separated timestamps, such as a log file
+	*	read or mapped into memory, without copying it.  Empty lines are
+	*	skipped, invalid lines produce a time of zero.  Either the UTC or the
+	*	local time is stored based on inLocal.  A final line without a
+	*	newline is parsed as is, so when parsing a file in pieces each piece
+	*	should end with a newline.
+	*	Returns the number of times stored in outTimes, at most inMaxTimes.
+	*	If outConsumed isn't null, it's set to the number of buffer bytes
+	*	consumed, which will be less than inLength when outTimes fills up.
+	*/
+	static size_t			ParseLines(
+								const char*				inBuffer,
+								size_t					inLength,
+								time32_t*				outTimes,
+								size_t					inMaxTimes,
+								bool					inLocal = false,
+								size_t*					outConsumed = nullptr);
+protected:
+	static bool				ParseCCLK(
+								const char*				inString,
+								size_t					inLength,
+								STimestamp&				outTimestamp);
+	static bool				ParseMonth(
+								const char*				inString,
+								size_t					inLength,
+								STimestamp&				outTimestamp);
+	static bool				ParseISO8601(
+								const char*				inString,
+								size_t					inLength,
+								STimestamp&				outTimestamp);
+	static bool				ParseMonthDate(
+								const char*				inDateStr,
+								uint16_t&				outYear,
+								uint8_t&				outMonth,
+								uint8_t&				outDay);
+	static bool				ParseTime(
+								const char*				inTimeStr,
+								uint32_t&				outSecondOfDay);
+	static bool				ToTime(
+								uint16_t				inYear,
+								uint8_t					inMonth,
+								uint8_t					inDay,
+								uint32_t				inSecondOfDay,
+								time32_t&				outTime);
+	static const uint32_t	kMonthNames[];
+};
+
+#endif // TimestampParser_h
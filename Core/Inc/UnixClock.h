@@ -0,0 +1,162 @@
+/*
+*	UnixClock.h, Copyright Jonathan Mackey 2026
+*
+*	A clock holding the current Unix time and everything derived from it.
+*
+*	Any number of clocks can exist, each at a different time, e.g. one per
+*	simulated receiver in a host tool.  The firmware uses the single default
+*	clock behind the static UnixTime API.  All of the per second and
+*	accessor functions are inline, and because the default clock is a
+*	static object its members have fixed addresses, so the firmware code is
+*	the same as when the state was static members of UnixTime.
+*
+*	Something needs to call Tick() once per second, generally an ISR specific
+*	to the MCU being used.  Each clock has its own seqlock, so a clock may be
+*	ticked by one thread while being read by others through Snapshot() and
+*	Time(), which access the time and generation with SequenceLock::Load()
+*	and Store().  The components are only read race free by the thread
+*	that ticks the clock.  Different clocks share nothing.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef UnixClock_h
+#define UnixClock_h
+
+#include "UnixTimeConverter.h"
+#include "SequenceLock.h"
+
+class UnixClock : public UnixTimeConverter<time32_t>
+{
+public:
+	/*
+	*	A consistent view of the current time.  subsecond is in ticks of
+	*	SubsecondTicksPerSecond() (0 if there's no subsecond source.)
+	*	generation is incremented each time the time is set rather than
+	*	ticked, so a change means the time may have jumped.
+	*/
+	struct STimeSnapshot
+	{
+		time32_t	seconds;
+		uint32_t	subsecond;
+		uint32_t	generation;
+	};
+							UnixClock(
+								time32_t				inTime = 0);
+	void					SetTime(
+								time32_t				inTime);
+	inline void				Tick(void)
+								{
+									mLock.WriteBegin();
+									if (mTime != mLeapSecondTick ||
+										mLeapSecondDelta == 0)
+									{
+										SequenceLock::Store(mTime, mTime + 1);
+										if (++mComponents.second >= 60)
+										{
+											CarryMinute();
+										}
+									} else
+									{
+										LeapSecondTick();
+									}
+									mLock.WriteEnd();
+									mTimeChanged = true;
+								}
+	/*
+	*	Schedules a leap second preceding inTime, the time at which the new
+	*	TAI-UTC takes effect (see LeapSeconds::NextLeapSecond.)  For a
+	*	positive leap second (inDelta +1) the components count 23:59:60 while
+	*	Time() holds at 23:59:59 for two seconds.  For a negative one 23:59:59
+	*	is skipped.  An inDelta of 0 cancels the leap second, as does
+	*	SetTime().
+	*/
+	void					ScheduleLeapSecond(
+								time32_t				inTime,
+								int8_t					inDelta);
+	/*
+	*	Returns the time without disabling interrupts.  The seconds,
+	*	subsecond and generation are guaranteed to be from the same instant.
+	*	See SequenceLock.h for the restriction on calling this from an ISR.
+	*/
+	STimeSnapshot			Snapshot(void) const;
+	/*
+	*	inCounter counts inTicksPerSecond ticks per second and is reset by
+	*	the same ISR that calls Tick(), e.g. the TIM2 tenths counter.
+	*/
+	void					SetSubsecondSource(
+								const volatile uint32_t*	inCounter,
+								uint32_t				inTicksPerSecond);
+	inline uint32_t			SubsecondTicksPerSecond(void) const
+								{return(mSubsecondTicksPerSecond);}
+	/*
+	*	The broken-down current time, maintained incrementally by Tick() and
+	*	re-derived from the time only when the time is set.  Unlike
+	*	ToComponents(Time()), reading these requires no division.
+	*/
+	inline const SComponents& CurrentComponents(void) const
+								{return(mComponents);}
+	inline uint16_t			CurrentDayOfYear(void) const	// 1 to 366
+								{return(mDayOfYear);}
+	inline uint8_t			CurrentDayOfWeek(void) const	// 0 = Sun, 6 = Sat
+								{return(mDayOfWeek);}
+	inline time32_t			Time(void) const
+								{return(SequenceLock::Load(mTime));}
+	inline time32_t			Date(void) const
+								{return(mTime - (mTime%86400));}
+	inline bool				TimeChanged(void) const
+								{return(mTimeChanged);}
+	inline void				ResetTimeChanged(void)
+								{mTimeChanged = false;}
+	inline bool				Format24Hour(void) const
+								{return(mFormat24Hour);}
+	inline void				SetFormat24Hour(
+								bool					inFormat24Hour)
+								{mFormat24Hour = inFormat24Hour;}
+	inline void				ResetSleepTime(void)
+								{mSleepTime = mTime + mSleepDelay;}
+	inline uint32_t			SleepDelay(void) const
+								{return(mSleepDelay);}
+	inline bool				TimeToSleep(void) const
+								{return(mSleepTime < mTime);}
+	inline void				SetSleepDelay(
+								uint32_t				inDelaySeconds)
+								{mSleepDelay = inDelaySeconds;}
+protected:
+	time32_t				mTime;
+	SComponents				mComponents;
+	uint16_t				mDayOfYear;
+	uint8_t					mDayOfWeek;
+	bool					mTimeChanged;
+	bool					mFormat24Hour;	// false = 12, true = 24
+	SequenceLock			mLock;	// Guards mTime, mComponents and mGeneration
+	uint32_t				mGeneration;
+	const volatile uint32_t*	mSubsecondCounter;
+	uint32_t				mSubsecondTicksPerSecond;
+	time32_t				mSleepTime;
+	uint32_t				mSleepDelay;
+	// Scheduled from the main loop while Tick() runs in an ISR
+	volatile time32_t		mLeapSecondTick;	// mTime of the tick that differs
+	volatile int8_t			mLeapSecondDelta;	// 0 = none scheduled
+
+	void					CarryMinute(void);
+	void					LeapSecondTick(void);
+	void					SyncComponents(void);
+};
+
+#endif // UnixClock_h
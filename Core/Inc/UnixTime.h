@@ -3,9 +3,10 @@
 *
 *	Utility class for converting to/from Unix time.
 *
-*	This class must be subclassed in order to use any functions that reference
-*	sTime and/or something needs to call Tick() once per second.  Tick() is
-*	generally called via an ISR specific to the MCU being used.
+*	The current time is kept by a default UnixClock, see UnixClock.h.  The
+*	static Time(), Tick(), etc. forward to it.  Something needs to call Tick()
+*	once per second.  Tick() is generally called via an ISR specific to the
+*	MCU being used.
 *
 *	GNU license:
 *	This program is free software: you can redistribute it and/or modify
@@ -28,17 +29,11 @@
 #ifndef UnixTime_h
 #define UnixTime_h
 
-#include <inttypes.h>
-
-/*
-*	Rather than use time_t, which can be 32 or 64 bit depending on the target,
-*	an explicite 32 bit type is used instead.
-*/
-typedef uint32_t time32_t;
+#include "UnixClock.h"
 
 // Note that STM32_CUBE_ is NOT a standard preprocessor macro.  It needs to be
 // defined in the STM32 project properties for both targets.
-#if !defined __MACH__ && !defined STM32_CUBE_
+#if !defined __MACH__ && !defined STM32_CUBE_ && !defined __linux__
 #define SUPPORT_DSDateTime	1
 #endif
 #ifdef SUPPORT_DSDateTime
@@ -46,34 +41,22 @@ union DSDateTime;
 class DS3231SN;
 #endif
 
-class UnixTime
+class UnixTime : public UnixTimeConverter<time32_t>
 {
 public:
+	typedef UnixClock::STimeSnapshot	STimeSnapshot;
 	static time32_t			StringToUnixTime(
 								const char*				inDateStr,
 								const char*				inTimeStr);
 	static time32_t			StringToUnixTime(
 								const char*				inDateTimeStr,
 								bool					inAdjustForTimezone=false);
-	static void				TimeComponents(
-								time32_t				inTime,
-								uint8_t&				outHour,
-								uint8_t&				outMinute,
-								uint8_t&				outSecond);
-	static time32_t			DateComponents(
-								time32_t				inTime,
-								uint16_t&				outYear,
-								uint8_t&				outMonth,
-								uint8_t&				outDay);
 	static bool				CreateTimeStr(
 								time32_t				inTime,
 								char*					outTimeStr);
 	static void				CreateDateStr(
 								time32_t				inTime,
 								char*					outDateStr);
-	static inline uint8_t	DayOfWeek(
-								time32_t				inTime)
-								{return(((inTime/kOneDay)+4)%7);}
 	static void				CreateDayOfWeekStr(
 								time32_t				inTime,
 								char*					outDayStr);
@@ -91,10 +74,10 @@ public:
 								DSDateTime&				outDSDateTime);
 #endif
 	static inline bool		Format24Hour(void)
-								{return(sFormat24Hour);}
+								{return(sClock.Format24Hour());}
 	static inline void		SetFormat24Hour(
 								bool					inFormat24Hour)
-								{sFormat24Hour = inFormat24Hour;}
+								{sClock.SetFormat24Hour(inFormat24Hour);}
 	static void				SDFatDateTime(
 								time32_t				inTime,
 								uint16_t*				outDate,
@@ -115,69 +98,65 @@ public:
 								time32_t				inTime);
 	static bool				CreateTimeStr(
 								char*					outTimeStr)
-								{return(CreateTimeStr(sTime, outTimeStr));}
+								{return(CreateTimeStr(sClock.Time(), outTimeStr));}
 	static void				CreateDateStr(
 								char*					outDateStr)
-								{return(CreateDateStr(sTime, outDateStr));}
+								{return(CreateDateStr(sClock.Time(), outDateStr));}
+	/*
+	*	The default clock.  The static functions below forward to it.
+	*/
+	static inline UnixClock& Clock(void)
+								{return(sClock);}
 	static inline void		Tick(void)
-								{
-									sTime++;
-									sTimeChanged = true;
-								}
+								{sClock.Tick();}
+	static inline STimeSnapshot Snapshot(void)
+								{return(sClock.Snapshot());}
+	static inline void		SetSubsecondSource(
+								const volatile uint32_t*	inCounter,
+								uint32_t				inTicksPerSecond)
+								{sClock.SetSubsecondSource(inCounter, inTicksPerSecond);}
+	static inline uint32_t	SubsecondTicksPerSecond(void)
+								{return(sClock.SubsecondTicksPerSecond());}
+	static inline const SComponents& CurrentComponents(void)
+								{return(sClock.CurrentComponents());}
+	static inline uint16_t	CurrentDayOfYear(void)	// 1 to 366
+								{return(sClock.CurrentDayOfYear());}
+	static inline uint8_t	CurrentDayOfWeek(void)	// 0 = Sun, 6 = Sat
+								{return(sClock.CurrentDayOfWeek());}
 	static inline time32_t	Time(void)
-								{return(sTime);}
+								{return(sClock.Time());}
 	static inline time32_t	Date(void)
-								{return(sTime - (sTime%kOneDay));}
+								{return(sClock.Date());}
 	static inline bool		TimeChanged(void)
-								{return(sTimeChanged);}
+								{return(sClock.TimeChanged());}
 	static inline void		ResetTimeChanged(void)
-								{sTimeChanged = false;}
+								{sClock.ResetTimeChanged();}
 	static void				SetUnixTimeFromSerial(void);													
-	static void				ResetSleepTime(void);
+	static inline void		ResetSleepTime(void)
+								{sClock.ResetSleepTime();}
 	static uint32_t			SleepDelay(void)
-								{return(sSleepDelay);}
+								{return(sClock.SleepDelay());}
 	static inline bool		TimeToSleep(void)
-								{return(sSleepTime < Time());}
-	static void				SetSleepDelay(
-								uint32_t				inDelaySeconds);
+								{return(sClock.TimeToSleep());}
+	static inline void		SetSleepDelay(
+								uint32_t				inDelaySeconds)
+								{sClock.SetSleepDelay(inDelaySeconds);}
 	static void				SDFatDateTimeCB(
 								uint16_t*				outDate,
 								uint16_t*				outTime);
 	static void				SetTimeFromExternalRTC(void);
-	struct SComponents
-	{
-		uint8_t		second;
-		uint8_t		minute;
-		uint8_t		hour;
-		uint8_t		day;
-		uint8_t		month;
-		uint16_t	year;
-	};
-	static void				ToComponents(
-								time32_t				inTime,
-								SComponents&			outComponents);
-	static time32_t			FromComponents(
-								const SComponents&		inComponents);
 protected:
 #ifdef SUPPORT_DSDateTime
 	static DS3231SN*		sExternalRTC;	// This is set via a subclass of UnixTime
 #endif
-	static time32_t			sSleepTime;
-	static time32_t			sTime;
-	static uint32_t			sSleepDelay;
-	static bool				sTimeChanged;
+	static UnixClock		sClock;
 
-	static bool				sFormat24Hour;	// false = 12, true = 24
 	static const uint8_t	kOneMinute;
 	static const uint16_t	kOneHour;
 	static const uint32_t	kOneDay;
 	static const uint32_t	kOneYear;
 	static const time32_t	kYear2000;
-	static const uint8_t	kDaysInMonth[];
 	static const uint16_t	kDaysTo[];
-	static const uint16_t	kDaysToLY[];
-	static const char		kMonth3LetterAbbr[];
-	static const char		kDay3LetterAbbr[];
 };
 
 #endif // UnixTime_h
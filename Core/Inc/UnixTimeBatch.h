@@ -0,0 +1,69 @@
+/*
+*	UnixTimeBatch.h, Copyright Jonathan Mackey 2026
+*
+*	Converts arrays of time32_t values to date/time components.
+*
+*	Intended for host tools that post-process logs of timestamps.  When
+*	compiled for a target with AVX2 or SSE2 (e.g. -march=native on x86-64)
+*	8 or 4 times are converted in parallel, with every division done as a
+*	multiply by a reciprocal.  All other targets, including the STM32, get a
+*	scalar loop, as does any build with UNIX_TIME_BATCH_SCALAR defined.  The
+*	results are identical to UnixTime::ToComponents.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef UnixTimeBatch_h
+#define UnixTimeBatch_h
+
+#include <stddef.h>
+#include "UnixTimeConverter.h"
+
+class UnixTimeBatch
+{
+public:
+	typedef SUnixTimeComponents	SComponents;
+	/*
+	*	Struct of arrays variant.  Each member points to an array of at least
+	*	inCount elements.
+	*/
+	struct SComponentsSoA
+	{
+		uint8_t*	second;
+		uint8_t*	minute;
+		uint8_t*	hour;
+		uint8_t*	day;
+		uint8_t*	month;
+		uint16_t*	year;
+	};
+	static void				ToComponentsBatch(
+								const time32_t*			inTimes,
+								size_t					inCount,
+								SComponents*			outComponents);
+	static void				ToComponentsBatch(
+								const time32_t*			inTimes,
+								size_t					inCount,
+								const SComponentsSoA&	outComponents);
+	/*
+	*	Returns the name of the instruction set used, "AVX2", "SSE2" or
+	*	"scalar".
+	*/
+	static const char*		InstructionSet(void);
+};
+
+#endif // UnixTimeBatch_h
@@ -0,0 +1,111 @@
+/*
+*	UnixTimeConverter.h, Copyright Jonathan Mackey 2026
+*
+*	Conversions between Unix time and date/time components, generic over the
+*	type used to hold the time.
+*
+*	The firmware uses the 32 bit unsigned time32_t, which covers 1970 to 2106.
+*	Host tools that need pre-1970 or far future times use the 64 bit signed
+*	time64_t via UnixTime64.  Both share the same calendar core, so the only
+*	difference is the width of the seconds arithmetic.  Years must be within
+*	1 to 65535 (the range of SUnixTimeComponents::year.)
+*
+*	The template member functions are defined in UnixTimeConverter.cpp and
+*	explicitly instantiated there for time32_t and time64_t.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef UnixTimeConverter_h
+#define UnixTimeConverter_h
+
+#include <inttypes.h>
+
+/*
+*	Rather than use time_t, which can be 32 or 64 bit depending on the target,
+*	an explicite 32 bit type is used instead.
+*/
+typedef uint32_t time32_t;
+/*
+*	Signed 64 bit time for host tools.  Negative values are before 1970.
+*/
+typedef int64_t time64_t;
+
+struct SUnixTimeComponents
+{
+	uint8_t		second;
+	uint8_t		minute;
+	uint8_t		hour;
+	uint8_t		day;
+	uint8_t		month;
+	uint16_t	year;
+};
+
+template <class TTime>
+class UnixTimeConverter
+{
+public:
+	typedef SUnixTimeComponents	SComponents;
+
+	static void				TimeComponents(
+								TTime					inTime,
+								uint8_t&				outHour,
+								uint8_t&				outMinute,
+								uint8_t&				outSecond);
+	/*
+	*	Returns the seconds elapsed since the start of the day.
+	*/
+	static TTime			DateComponents(
+								TTime					inTime,
+								uint16_t&				outYear,
+								uint8_t&				outMonth,
+								uint8_t&				outDay);
+	static inline uint8_t	DayOfWeek(
+								TTime					inTime)	// 0 = Sun, 6 = Sat
+								{return(((Days(inTime) % 7) + 11) % 7);}
+	static void				ToComponents(
+								TTime					inTime,
+								SComponents&			outComponents);
+	static TTime			FromComponents(
+								const SComponents&		inComponents);
+	/*
+	*	Returns the number of days since 1-JAN-1970, rounded toward negative
+	*	infinity so that times before 1970 land on the correct day.
+	*/
+	static inline TTime		Days(
+								TTime					inTime)
+								{
+									TTime	days = inTime / 86400;
+									return(IsNegative(inTime - (days * 86400)) ?
+												(days - 1) : days);
+								}
+protected:
+	/*
+	*	Overloaded so that no comparison is generated for unsigned types.
+	*/
+	static inline bool		IsNegative(
+								uint32_t)
+								{return(false);}
+	static inline bool		IsNegative(
+								int64_t					inValue)
+								{return(inValue < 0);}
+};
+
+typedef UnixTimeConverter<time64_t> UnixTime64;
+
+#endif // UnixTimeConverter_h
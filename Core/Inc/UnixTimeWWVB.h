@@ -25,12 +25,25 @@
 *	notices in any redistribution of this code.
 *
 */
+#ifndef UnixTimeWWVB_h
+#define UnixTimeWWVB_h
 
 #include "UnixTime.h"
+#include "DSTBitCache.h"
 #ifdef STM32_CUBE_
 #include "stm32f1xx_hal.h"
 #endif
 
+/*
+*	Set WWVB_ISR_TIMING to 1 to measure the RTC second ISR execution time in
+*	CPU cycles using the DWT cycle counter.  See ISRTiming().
+*/
+class WWVBPMScheduler;
+
+#ifndef WWVB_ISR_TIMING
+#define WWVB_ISR_TIMING	0
+#endif
+
 // See https://en.wikipedia.org/wiki/WWVB for a description of the fields.
 struct SWWVBTimeCode
 {
@@ -62,6 +75,85 @@ struct SWWVBTimeCode
 	uint8_t	p0;					// 59
 };
 
+/*
+*	The same frame as SWWVBTimeCode packed into two bitplanes, bit n being
+*	second n.  A set marker bit is a marker, otherwise the data bit is the
+*	0 or 1 being sent.  data is always 0 where marker is set.  At 16 bytes
+*	a frame can be copied in two words and host tools can keep thousands
+*	of them.
+*/
+struct SWWVBPackedFrame
+{
+	uint64_t	data;
+	uint64_t	marker;
+	/*
+	*	Returns the same 0, 1 or 2 (marker) as the corresponding SWWVBTimeCode
+	*	byte.  inSecond is 0 to 59.
+	*/
+	inline uint8_t			GetSymbol(
+								uint32_t				inSecond) const
+								{
+									return((uint8_t)((((marker >> inSecond) & 1) << 1) |
+													((data >> inSecond) & 1)));
+								}
+	/*
+	*	Returns the data bits of an 8421 BCD digit starting at inFirstSecond.
+	*	The digit is sent most significant bit first, so it's bit reversed
+	*	using a nibble lookup packed into a constant.
+	*/
+	static inline uint64_t	DigitAt(
+								uint8_t					inDigit,
+								uint32_t				inFirstSecond)
+								{
+									return(((0xF7B3D591E6A2C480ULL >> (inDigit * 4)) & 0xF) << inFirstSecond);
+								}
+};
+
+/*
+*	A WWVB phase modulation (BPSK) frame, sent alongside the amplitude
+*	modulated frame.  Bit n is second n's phase, 1 being the carrier
+*	inverted (180 degrees.)
+*/
+struct SWWVBPMFrame
+{
+	uint64_t	phase;
+	inline uint32_t			GetPhase(
+								uint32_t				inSecond) const
+								{return((uint32_t)(phase >> inSecond) & 1);}
+};
+
+/*
+*	The decoded values of a frame, shared by both frame representations.
+*/
+struct SWWVBFrameFields
+{
+	uint8_t		minute;
+	uint8_t		hour;
+	uint16_t	dayOfYear;
+	uint8_t		year;				// 0 to 99
+	uint8_t		dutSign;			// eDUT
+	uint8_t		dutValue;			// Tenths of a second
+	uint8_t		dstStatus;			// eDST
+	bool		leapYearIndicator;
+	bool		leapSecondAtEOM;
+};
+
+/*
+*	The frame values taken from the leap second and DUT1 tables and the
+*	DST bit cache, and the span of time they apply to.  The span is the
+*	part of the UTC day containing the time they were loaded for without a
+*	DUT1 change.  PrepareNextFrame() keeps one current so that the RTC ISR
+*	never has to query the tables or the cache.
+*/
+struct SWWVBTableValues
+{
+	time32_t	start;				// Valid from start up to end
+	time32_t	end;
+	int8_t		leapSecondAtEOM;	// +1, -1 or 0
+	int8_t		dut1;				// Tenths of a second
+	uint8_t		dstStatus;			// eDST of the UTC day
+};
+
 class UnixTimeWWVB : public UnixTime
 {
 public:
@@ -73,6 +165,69 @@ public:
 								UART_HandleTypeDef*	inUART2Hndl);
 	static void				WakeUpGPSModule(void);
 	static void				PutGPSModuleToSleep(void);
+	/*
+	*	Call from the main loop.  Builds the frame for the next minute in the
+	*	idle one of two frame buffers so that the RTC ISR only has to swap
+	*	buffers at the start of the minute.  Does nothing once the next
+	*	minute's frame is ready.  It also keeps the SWWVBTableValues the ISR
+	*	builds a frame from when the next one isn't ready, and makes the
+	*	table changes requested from ISRs.
+	*/
+	static void				PrepareNextFrame(void);
+	/*
+	*	Call after setting the time.  At the next second the RTC ISR builds
+	*	the frame for the minute it's in and sends it from that second on,
+	*	rather than sending the stale frame until the minute ends.  Does
+	*	nothing when WWVB_MID_MINUTE_JOIN is 0.
+	*/
+	static void				JoinMidMinute(void);
+	/*
+	*	The scheduler PrepareNextFrame() uses to select each minute's phase
+	*	modulation frame, e.g. to turn on its extended message.
+	*/
+	static WWVBPMScheduler&	PMScheduler(void);
+	/*
+	*	Sets the rule the DST bits are derived from, nullptr being the
+	*	default US rule.  The frames from the next minute on use the new
+	*	rule.  inRule must remain valid while it's in use.  Call from the
+	*	main loop.
+	*/
+	static void				SetTimeZoneRule(
+								TimeZoneRule*			inRule);
+	/*
+	*	The delay in milliseconds between the start of the second in an RMC
+	*	sentence and the sentence being received (default 300.)  Used to
+	*	pick the nearest second when the GPS sets the time.
+	*/
+	static void				SetGPSLatency(
+								int16_t					inMilliseconds);
+	static time32_t			CompensateLatency(
+								time32_t				inTime);
+	/*
+	*	For testing how receivers handle a leap second: adds a positive
+	*	(inDelta +1) or negative (-1) leap second at the end of the current
+	*	month and sets the time to two minutes before it.  Returns false if
+	*	the leap second couldn't be added, e.g. a real one is already
+	*	scheduled for a later month.  Call from the main loop.  A
+	*	"$PLEAP,+1*hh" or "$PLEAP,-1*hh" sentence received by the UART
+	*	requests it (see LeapSeconds::ParseSentence.)
+	*/
+	static bool				SimulateLeapSecond(
+								int8_t					inDelta);
+#if WWVB_ISR_TIMING
+	struct SISRTiming
+	{
+		uint32_t	last;		// Cycles, most recent second
+		uint32_t	max;		// Cycles, all seconds
+		uint32_t	minuteMax;	// Cycles, seconds starting a minute
+		uint32_t	fallbacks;	// Frames the ISR had to build itself
+	};
+	static const SISRTiming& ISRTiming(void);
+	/*
+	*	Transmits max and minuteMax as hex via UART2.
+	*/
+	static void				ReportISRTiming(void);
+#endif
 #endif
 	/*
 	*	UnixTimeFromRMCString is a minimal parser that ONLY extracts the date
@@ -91,6 +246,71 @@ public:
 	static void				LoadTimeCodeStruct(
 								time32_t				inTime,
 								SWWVBTimeCode&			outTCS);
+	/*
+	*	Same as above but from already broken-down components, such as those
+	*	returned by CurrentComponents(), and inValues loaded for the same
+	*	time by LoadTableValues().  No division is performed and neither the
+	*	leap second and DUT1 tables nor the DST bit cache are queried.
+	*/
+	static void				LoadTimeCodeStruct(
+								const SComponents&		inComponents,
+								uint16_t				inDayOfYear,
+								const SWWVBTableValues&	inValues,
+								SWWVBTimeCode&			outTCS);
+	/*
+	*	Packed equivalents of LoadTimeCodeStruct.
+	*/
+	static void				LoadPackedFrame(
+								time32_t				inTime,
+								SWWVBPackedFrame&		outFrame);
+	static void				LoadPackedFrame(
+								const SComponents&		inComponents,
+								uint16_t				inDayOfYear,
+								const SWWVBTableValues&	inValues,
+								SWWVBPackedFrame&		outFrame);
+	/*
+	*	Phase modulation frame builders.  The frame carries the minute of the
+	*	century, its Hamming parity, the DST status and any leap second
+	*	scheduled for the end of the month.  The notice bit and dst_next are
+	*	0, WWVBPMScheduler fills them when its SetDSTNext() is on.  inValues
+	*	are those loaded for inTime by LoadTableValues().
+	*/
+	static void				LoadPMFrame(
+								time32_t				inTime,
+								SWWVBPMFrame&			outFrame);
+	static void				LoadPMFrame(
+								time32_t				inTime,
+								const SWWVBTableValues&	inValues,
+								SWWVBPMFrame&			outFrame);
+	/*
+	*	Loads the table values for inTime.  This queries the leap second and
+	*	DUT1 tables, which moves their cursors, and the DST bit cache, which
+	*	may reload for a new year, so on the STM32 it's only called from the
+	*	main loop.
+	*/
+	static void				LoadTableValues(
+								time32_t				inTime,
+								SWWVBTableValues&		outValues);
+	/*
+	*	Minutes since 1-JAN-2000 00:00 UTC, as sent in the PM frame.
+	*/
+	static inline uint32_t	MinuteOfCentury(
+								time32_t				inTime)
+								{return((inTime - kYear2000)/60);}
+	/*
+	*	Returns the eDST status for the UTC day from DSTCache().
+	*/
+	static inline uint8_t	DSTStatus(
+								uint16_t				inYear,
+								uint16_t				inDayOfYear)	// 1 to 366
+								{return(sDSTCache.Status(inYear, inDayOfYear));}
+	/*
+	*	The DST bit cache.  Its Rule() is the one the DST bits and the phase
+	*	modulation DST fields are derived from.  On the STM32 the rule is set
+	*	with SetTimeZoneRule() rather than directly.
+	*/
+	static inline DSTBitCache& DSTCache(void)
+								{return(sDSTCache);}
 	enum eDST
 	{					// Bit: 57	58
 		eDST_NotInEffect,	//  0	 0
@@ -112,6 +332,18 @@ protected:
 //	time32_t	sDSTStartTime;	// Month day start time (no year component)
 //	time32_t	sDSTEndTime;	// Month day end time (zero if no DST)
 	
+	static DSTBitCache		sDSTCache;
+
+#ifdef STM32_CUBE_
+	static void				PublishTableValues(
+								time32_t				inTime);
+#endif
+
+	static void				LoadFrameFields(
+								const SComponents&		inComponents,
+								uint16_t				inDayOfYear,
+								const SWWVBTableValues&	inValues,
+								SWWVBFrameFields&		outFields);
 	static void				ToTimeCode8421(
 								uint16_t				inValue,
 								uint8_t					out8421_100[4],
@@ -121,3 +353,5 @@ protected:
 								uint8_t					inValue,
 								uint8_t					out8421[4]);
 };
+
+#endif // UnixTimeWWVB_h
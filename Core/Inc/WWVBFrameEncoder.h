@@ -0,0 +1,72 @@
+/*
+*	WWVBFrameEncoder.h, Copyright Jonathan Mackey 2026
+*
+*	Incremental WWVB packed frame encoder.
+*
+*	From one minute to the next usually only the minute digits change.  The
+*	encoder keeps the previous frame along with its broken-down time, and
+*	when asked for the following minute it carries the minute into the
+*	hours, day, month and year without any division, rewriting only the
+*	fields whose value changed.  The day level bits (DST, leap year and
+*	leap second) are only re-derived when the day changes.  DUT1 is checked
+*	each minute, which is a compare (see DUT1Schedule.)  Any other
+*	request, such as after the time is set, rebuilds the whole frame.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef WWVBFrameEncoder_h
+#define WWVBFrameEncoder_h
+
+#include "UnixTimeWWVB.h"
+
+class WWVBFrameEncoder
+{
+public:
+							WWVBFrameEncoder(void);
+	/*
+	*	Returns the frame for the minute containing inTime.
+	*/
+	const SWWVBPackedFrame&	Encode(
+								time32_t				inTime);
+	/*
+	*	Rebuilds the frame from scratch for the minute containing inTime.
+	*/
+	void					Rebuild(
+								time32_t				inTime);
+	/*
+	*	Forces the next Encode() to rebuild, e.g. after a table used to build
+	*	the frame changes.
+	*/
+	inline void				Invalidate(void)
+								{mTime = 0;}
+	inline const SWWVBPackedFrame& Frame(void) const
+								{return(mFrame);}
+	inline time32_t			FrameTime(void) const	// Start of the minute
+								{return(mTime);}
+protected:
+	SWWVBPackedFrame		mFrame;
+	time32_t				mTime;		// 0 = no frame yet
+	SUnixTimeComponents		mComponents;
+	uint16_t				mDayOfYear;
+	int8_t					mDUT1;
+
+	void					NextMinute(void);
+};
+
+#endif // WWVBFrameEncoder_h
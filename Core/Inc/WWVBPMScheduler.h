@@ -0,0 +1,122 @@
+/*
+*	WWVBPMScheduler.h, Copyright Jonathan Mackey 2026
+*
+*	Selects the WWVB phase modulation frame sent each minute.
+*
+*	Most minutes send the time frame built by UnixTimeWWVB::LoadPMFrame().
+*	Its notice bit and dst_next field are left 0 unless SetDSTNext() turns
+*	on the simulator's own use of them, filled from the TimeZoneRule of
+*	UnixTimeWWVB::DSTCache() (see DSTNextBits().)
+*
+*	When SetExtendedMessage() turns it on, minutes 10 to 15 and 40 to 45
+*	of each hour instead send one sixth of a six minute extended message,
+*	marked by the sync_M word in place of sync_T.  The whole message is
+*	built once, during the minute before the window (or on demand after
+*	the time is set), as six complete frames, so each extended minute is
+*	only a copy.  The per second ISR work is the same for every frame type.
+*
+*	The message carries the DST schedule from the same TimeZoneRule:
+*		Bits	Field
+*		 4		Message type (kDSTScheduleMessage)
+*		26		Next DST start, minute of century (0 = no DST)
+*		26		Next DST end, minute of century (0 = no DST)
+*		 8		Standard offset, signed, 15 minute units east of UTC
+*		 8		DST offset, signed, 15 minute units east of UTC
+*		16		CRC-16-CCITT of the above
+*	The 88 bit payload is sent three times, followed by 12 zero bits, for
+*	the 276 bits (6 x 46) available.  This layout is the simulator's own and
+*	is not the NIST extended mode message, whose content is not published,
+*	so it's off by default and only useful to receivers written for it.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef WWVBPMScheduler_h
+#define WWVBPMScheduler_h
+
+#include "UnixTimeWWVB.h"
+#include "TimeZoneRule.h"
+
+class WWVBPMScheduler
+{
+public:
+							WWVBPMScheduler(void);
+	/*
+	*	Discards everything derived from the rule, call after it changes
+	*	(see UnixTimeWWVB::SetTimeZoneRule().)
+	*/
+	void					Invalidate(void);
+	/*
+	*	Turns the private extended DST schedule message on or off (the
+	*	default.)  When off, every minute sends a time frame.
+	*/
+	void					SetExtendedMessage(
+								bool					inSend);
+	/*
+	*	Turns the private meaning of the time frame's notice bit and
+	*	dst_next, the days to the next DST transition, on or off (the
+	*	default.)  When off, both are sent as 0.
+	*/
+	void					SetDSTNext(
+								bool					inSend);
+	/*
+	*	Returns true if the minute containing inTime sends an extended frame.
+	*/
+	static inline bool		IsExtendedMinute(
+								time32_t				inTime)
+								{
+									uint32_t	minute = (inTime / 60) % 30;
+									return(minute >= kFirstExtendedMinute &&
+										minute < (kFirstExtendedMinute + kExtendedMinutes));
+								}
+	/*
+	*	Loads the frame for the minute containing inTime.  Call this for
+	*	each minute, ahead of the minute, from a low priority context.
+	*/
+	void					LoadFrame(
+								time32_t				inTime,
+								SWWVBPMFrame&			outFrame);
+	static const uint32_t	kFirstExtendedMinute = 10;	// And 40
+	static const uint32_t	kExtendedMinutes = 6;
+	static const uint32_t	kMessageBitsPerMinute = 46;	// Seconds 13 to 58
+	static const uint32_t	kSyncM = 0x1A3A;
+	static const uint8_t	kDSTScheduleMessage = 1;
+protected:
+	bool					mExtendedMessage;
+	bool					mDSTNext;
+	time32_t				mDSTNextDay;	// Day of mDSTNextBits, 1 = none
+	uint64_t				mDSTNextBits;
+	time32_t				mMessageStart;	// First minute of mFrames, 0 = none
+	SWWVBPMFrame			mFrames[kExtendedMinutes];
+	uint32_t				mBitIndex;		// BuildMessage() write position
+	uint16_t				mCRC;			// Of the bits written by PutBits()
+
+	void					BuildMessage(
+								time32_t				inStart);
+	uint64_t				DSTNextBits(
+								time32_t				inTime);
+	void					PutBits(
+								uint32_t				inValue,
+								uint32_t				inWidth);
+	bool					NextTransition(
+								time32_t				inTime,
+								bool					inStart,
+								time32_t&				outTime);
+};
+
+#endif // WWVBPMScheduler_h
@@ -0,0 +1,216 @@
+/*
+*	WWVBSynthesizer.h, Copyright Jonathan Mackey 2026
+*
+*	Synthesizes the time code signal as sampled data for host tools (Linux
+*	and macOS only), e.g. to test SDR based receivers.  The output is
+*	either the sampled carrier (16 bit or float) or its complex baseband
+*	envelope (interleaved float I/Q), optionally offset from the carrier by
+*	an IF.  For sound cards there is also a 16 bit square wave at a third
+*	of the carrier, whose third harmonic is the carrier (e.g. 20 kHz for
+*	60 kHz.)
+*
+*	One period of the carrier (the shortest whole number of samples that
+*	holds a whole number of cycles) is precomputed and repeated out to the
+*	block size, so the inner loop is a multiply of the table by the
+*	tenth's amplitude.  When compiled for AVX2 or SSE2 the loop uses 8 or 4
+*	float lanes.  Samples are passed to the sink a block at a time, so
+*	memory use is bounded whatever the length of the stream.
+*
+*	The amplitude and phase of each tenth of a second come from the
+*	station's carrier patterns (see TimeCodeStation) and the optional phase
+*	modulation, the PM frame for WWVB and the pseudo-random sequence for
+*	DCF77 (see DCF77PRN.)  A reduced carrier is 17 dB down by default, as
+*	broadcast by WWVB.
+*
+*	An optional ChannelModel degrades each block before it's converted and
+*	passed to the sink, and jitters the edges between tenths.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#ifndef WWVBSynthesizer_h
+#define WWVBSynthesizer_h
+
+#if defined __linux__ || defined __MACH__
+#include <stdio.h>
+#include <vector>
+#include "UnixTimeWWVB.h"
+#include "TimeCodeStation.h"
+#include "ChannelModel.h"
+
+/*
+*	Receives each block of samples.  Returns false if the samples couldn't
+*	be written.
+*/
+typedef bool (*SampleSink)(
+	void*		inContext,
+	const void*	inData,
+	size_t		inBytes);
+
+class WWVBSynthesizer
+{
+public:
+	enum EOutput
+	{
+		eCarrierS16,	// Sampled carrier, 16 bit signed
+		eCarrierF32,	// Sampled carrier, float
+		eBasebandCF32,	// Complex envelope, interleaved float I/Q
+		eSubharmonicS16	// Square wave at a third of the carrier, 16 bit
+	};
+	/*
+	*	WriteSecond's inPhase is 0, eInverted, or for DCF77 ePRN | the time
+	*	bit.
+	*/
+	enum
+	{
+		eInverted	= 1,
+		ePRN		= 2
+	};
+	/*
+	*	inFrequency is the carrier in Hz for the carrier and subharmonic
+	*	outputs and the IF offset (often 0) for the baseband output.
+	*	inSampleRate must be a multiple of 10 so that each tenth is a whole
+	*	number of samples.  For the subharmonic output inFrequency must be a
+	*	multiple of 3.  Check Valid() before use.  The samples are written
+	*	to stdout until SetSink() is called.
+	*/
+							WWVBSynthesizer(
+								uint32_t				inSampleRate,
+								int32_t					inFrequency,
+								EOutput					inOutput,
+								const STimeCodeStation&	inStation = TimeCodeStation::kWWVB);
+	/*
+	*	Returns false if the sample rate or frequency isn't valid, or the
+	*	carrier period is more than kMaxPeriod samples.
+	*/
+	inline bool				Valid(void) const
+								{return(mPeriod != 0);}
+	void					SetSink(
+								SampleSink				inSink,
+								void*					inContext);
+	/*
+	*	A SampleSink that writes to the FILE* inContext.
+	*/
+	static bool				FileSink(
+								void*					inContext,
+								const void*				inData,
+								size_t					inBytes);
+	/*
+	*	inChannel may be nullptr for a clean signal (the default.)  The
+	*	channel's position should be at the start of the stream.
+	*/
+	void					SetChannel(
+								ChannelModel*			inChannel);
+	/*
+	*	Full carrier amplitude, 0 to 1 of full scale (default 0.9.)
+	*/
+	void					SetAmplitude(
+								float					inAmplitude);
+	/*
+	*	Level of the reduced carrier relative to full, in dB (default -17.)
+	*/
+	void					SetReducedLevel(
+								float					inDB);
+	/*
+	*	Writes one second given its symbol (see STimeCodeFrame::GetSymbol),
+	*	its second within the minute and its phase (see above.)  ePRN is
+	*	ignored by the subharmonic output and other stations.  Returns
+	*	the number of samples written, which is the sample rate unless the
+	*	channel jitters the edges.
+	*/
+	uint32_t				WriteSecond(
+								uint32_t				inSymbol,
+								uint32_t				inSecond,
+								uint32_t				inPhase);
+	/*
+	*	Writes second inSecond of a frame from LoadPackedFrame.  inPMFrame
+	*	may be nullptr for no phase modulation.
+	*/
+	uint32_t				WriteSecond(
+								const SWWVBPackedFrame&	inFrame,
+								const SWWVBPMFrame*		inPMFrame,
+								uint32_t				inSecond);
+	/*
+	*	Writes inSeconds seconds starting at inStart.  WWVB frames are built
+	*	with LoadTimeCodeStruct (and LoadPMFrame when inPhaseModulation),
+	*	other stations' frames with a TimeCodeEncoder.  inPhaseModulation
+	*	also adds DCF77's pseudo-random phase modulation.  outSamples is the
+	*	number of samples written.  Stops and returns false if the sink
+	*	fails.
+	*/
+	bool					Stream(
+								time32_t				inStart,
+								uint32_t				inSeconds,
+								bool					inPhaseModulation,
+								uint64_t&				outSamples);
+	/*
+	*	Writes any samples still in the block buffer.  Returns false if the
+	*	sink failed since the last Flush().
+	*/
+	bool					Flush(void);
+	inline uint32_t			SampleRate(void) const
+								{return(mSampleRate);}
+	inline uint32_t			BytesPerSample(void) const
+								{return(mOutput == eCarrierF32 ? 4 : (mOutput == eBasebandCF32 ? 8 : 2));}
+	/*
+	*	Returns the name of the instruction set used, "AVX2", "SSE2" or
+	*	"scalar".
+	*/
+	static const char*		InstructionSet(void);
+	static const uint32_t	kBlockSamples = 4096;
+	static const uint32_t	kMaxPeriod = 65536;
+protected:
+	const STimeCodeStation&	mStation;
+	uint32_t				mSampleRate;
+	int32_t					mFrequency;	// As passed to the constructor
+	EOutput					mOutput;
+	uint32_t				mChannels;	// Floats per sample, 1 or 2
+	uint32_t				mPeriod;	// Samples, 0 = invalid
+	uint32_t				mPhase;		// Sample index within the period
+	uint32_t				mFill;		// Samples in mBlock
+	float					mFullLevel;
+	float					mReducedLevel;
+	float					mReducedRatio;	// mReducedLevel/mFullLevel
+	std::vector<float>		mTable;		// The carrier, kBlockSamples + mPeriod samples
+	uint32_t				mTableFloats;	// Per table
+	bool					mPRN;		// ePRN is sent, tables 1 and 2 are added at first use
+	std::vector<float>		mBlock;
+	std::vector<int16_t>	mS16Block;
+	SampleSink				mSink;
+	void*					mSinkContext;
+	bool					mSinkFailed;
+	ChannelModel*			mChannel;
+	uint64_t				mEdge;		// Of the current second's first tenth
+	int32_t					mEdgeOffset;	// Of the current run's first edge
+
+	void					LoadTable(
+								uint32_t				inTable);
+	void					WriteSamples(
+								float					inAmplitude,
+								uint32_t				inCount,
+								uint32_t				inTable = 0);
+	void					WriteBlock(void);
+	void					WritePRN(
+								float					inAmplitude,
+								uint32_t				inPosition,
+								uint32_t				inCount,
+								uint32_t				inTimeBit);
+};
+#endif
+
+#endif // WWVBSynthesizer_h
@@ -0,0 +1,460 @@
+/*
+*	ChannelModel.cpp, Copyright Jonathan Mackey 2026
+*
+*	Degrades synthesized samples the way a radio channel would.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "ChannelModel.h"
+#if defined __linux__ || defined __MACH__
+#include <math.h>
+
+#if defined __AVX2__ || defined __SSE2__
+#include <immintrin.h>
+#endif
+
+/*
+*	Gaussians are generated a chunk at a time.  Chunks are also split where
+*	the fade segment or burst slot changes, so within a chunk the gain is
+*	linear and the noise level is constant.
+*/
+static const uint32_t	kChunkFloats = 4096;
+static const uint32_t	kCounterMask = 0x7FFFFFFF;	// See Key()
+// The Irwin-Hall sum of four 16 bit uniforms has a mean of 2 * 65535 and a
+// standard deviation of very nearly 65536/sqrt(3).
+static const int32_t	kGaussianMean = 131070;
+static const float		kGaussianScale = 1.7320508f / 65536.0f;
+
+#if defined __AVX2__
+/********************************* HashLanes **********************************/
+/*
+*	Hash() of 8 lanes.
+*/
+static inline __m256i HashLanes(
+	__m256i	inValue)
+{
+	__m256i	x = _mm256_xor_si256(inValue, _mm256_srli_epi32(inValue, 16));
+	x = _mm256_mullo_epi32(x, _mm256_set1_epi32(0x7feb352d));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+	x = _mm256_mullo_epi32(x, _mm256_set1_epi32((int)0x846ca68b));
+	return(_mm256_xor_si256(x, _mm256_srli_epi32(x, 16)));
+}
+#elif defined __SSE2__
+/********************************** MulLo32 ***********************************/
+/*
+*	SSE2 has no 32 bit multiply low, so it's built from the even/odd lane
+*	32x32->64 multiply.
+*/
+static inline __m128i MulLo32(
+	__m128i	inA,
+	__m128i	inB)
+{
+	__m128i	even = _mm_mul_epu32(inA, inB);
+	__m128i	odd = _mm_mul_epu32(_mm_srli_epi64(inA, 32), _mm_srli_epi64(inB, 32));
+	return(_mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)),
+								_mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0))));
+}
+
+/********************************* HashLanes **********************************/
+/*
+*	Hash() of 4 lanes.
+*/
+static inline __m128i HashLanes(
+	__m128i	inValue)
+{
+	__m128i	x = _mm_xor_si128(inValue, _mm_srli_epi32(inValue, 16));
+	x = MulLo32(x, _mm_set1_epi32(0x7feb352d));
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+	x = MulLo32(x, _mm_set1_epi32((int)0x846ca68b));
+	return(_mm_xor_si128(x, _mm_srli_epi32(x, 16)));
+}
+#endif
+
+/********************************* FillNoise **********************************/
+/*
+*	outNoise[i] = ChannelModel::Gaussian(inKey, inCounter + i) * inSigma
+*	inCounter + inCount must not exceed 2^31.  The vector and scalar paths
+*	give identical results.
+*/
+static inline void FillNoise(
+	uint32_t	inKey,
+	uint32_t	inCounter,
+	float		inSigma,
+	float*		outNoise,
+	uint32_t	inCount)
+{
+	float		scale = kGaussianScale * inSigma;
+	uint32_t	i = 0;
+#if defined __AVX2__
+	__m256i	key = _mm256_set1_epi32((int)inKey);
+	__m256i	lanes = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+	__m256i	one = _mm256_set1_epi32(1);
+	__m256i	low16 = _mm256_set1_epi32(0xFFFF);
+	__m256i	mean = _mm256_set1_epi32(kGaussianMean);
+	__m256	scaleLanes = _mm256_set1_ps(scale);
+	for (; (i + 8) <= inCount; i += 8)
+	{
+		__m256i	counter = _mm256_add_epi32(_mm256_set1_epi32((int)((inCounter + i) * 2)), lanes);
+		__m256i	h0 = HashLanes(_mm256_xor_si256(counter, key));
+		__m256i	h1 = HashLanes(_mm256_xor_si256(_mm256_or_si256(counter, one), key));
+		__m256i	sum = _mm256_add_epi32(
+						_mm256_add_epi32(_mm256_and_si256(h0, low16), _mm256_srli_epi32(h0, 16)),
+						_mm256_add_epi32(_mm256_and_si256(h1, low16), _mm256_srli_epi32(h1, 16)));
+		_mm256_storeu_ps(&outNoise[i],
+			_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(sum, mean)), scaleLanes));
+	}
+#elif defined __SSE2__
+	__m128i	key = _mm_set1_epi32((int)inKey);
+	__m128i	lanes = _mm_setr_epi32(0, 2, 4, 6);
+	__m128i	one = _mm_set1_epi32(1);
+	__m128i	low16 = _mm_set1_epi32(0xFFFF);
+	__m128i	mean = _mm_set1_epi32(kGaussianMean);
+	__m128	scaleLanes = _mm_set1_ps(scale);
+	for (; (i + 4) <= inCount; i += 4)
+	{
+		__m128i	counter = _mm_add_epi32(_mm_set1_epi32((int)((inCounter + i) * 2)), lanes);
+		__m128i	h0 = HashLanes(_mm_xor_si128(counter, key));
+		__m128i	h1 = HashLanes(_mm_xor_si128(_mm_or_si128(counter, one), key));
+		__m128i	sum = _mm_add_epi32(
+						_mm_add_epi32(_mm_and_si128(h0, low16), _mm_srli_epi32(h0, 16)),
+						_mm_add_epi32(_mm_and_si128(h1, low16), _mm_srli_epi32(h1, 16)));
+		_mm_storeu_ps(&outNoise[i],
+			_mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(sum, mean)), scaleLanes));
+	}
+#endif
+	for (; i < inCount; i++)
+	{
+		uint32_t	h0 = ChannelModel::Hash(((inCounter + i) * 2) ^ inKey);
+		uint32_t	h1 = ChannelModel::Hash((((inCounter + i) * 2) | 1) ^ inKey);
+		int32_t		sum = (int32_t)((h0 & 0xFFFF) + (h0 >> 16) + (h1 & 0xFFFF) + (h1 >> 16));
+		outNoise[i] = (float)(sum - kGaussianMean) * scale;
+	}
+}
+
+/********************************* ApplyGain **********************************/
+/*
+*	ioBlock[i] = ioBlock[i] * (inGain + inStep * (i / inChannels)) + inNoise[i]
+*	inNoise may be nullptr for no noise.
+*/
+static inline void ApplyGain(
+	float*			ioBlock,
+	const float*	inNoise,
+	uint32_t		inCount,
+	uint32_t		inChannels,
+	float			inGain,
+	float			inStep)
+{
+	uint32_t	i = 0;
+#if defined __AVX2__
+	__m256	ramp = _mm256_mul_ps(_mm256_set1_ps(inStep), inChannels == 1 ?
+						_mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7) :
+						_mm256_setr_ps(0, 0, 1, 1, 2, 2, 3, 3));
+	for (; (i + 8) <= inCount; i += 8)
+	{
+		__m256	gain = _mm256_add_ps(_mm256_set1_ps(inGain + inStep * (float)(i / inChannels)), ramp);
+		__m256	sample = _mm256_mul_ps(_mm256_loadu_ps(&ioBlock[i]), gain);
+		if (inNoise)
+		{
+			sample = _mm256_add_ps(sample, _mm256_loadu_ps(&inNoise[i]));
+		}
+		_mm256_storeu_ps(&ioBlock[i], sample);
+	}
+#elif defined __SSE2__
+	__m128	ramp = _mm_mul_ps(_mm_set1_ps(inStep), inChannels == 1 ?
+						_mm_setr_ps(0, 1, 2, 3) : _mm_setr_ps(0, 0, 1, 1));
+	for (; (i + 4) <= inCount; i += 4)
+	{
+		__m128	gain = _mm_add_ps(_mm_set1_ps(inGain + inStep * (float)(i / inChannels)), ramp);
+		__m128	sample = _mm_mul_ps(_mm_loadu_ps(&ioBlock[i]), gain);
+		if (inNoise)
+		{
+			sample = _mm_add_ps(sample, _mm_loadu_ps(&inNoise[i]));
+		}
+		_mm_storeu_ps(&ioBlock[i], sample);
+	}
+#endif
+	for (; i < inCount; i++)
+	{
+		ioBlock[i] *= inGain + inStep * (float)(i / inChannels);
+		if (inNoise)
+		{
+			ioBlock[i] += inNoise[i];
+		}
+	}
+}
+
+/******************************** ChannelModel ********************************/
+ChannelModel::ChannelModel(
+	uint32_t	inSampleRate,
+	uint32_t	inChannels,
+	uint64_t	inSeed)
+	: mSampleRate(inSampleRate), mChannels(inChannels == 2 ? 2 : 1),
+	  mSeed(inSeed), mSample(0), mSignalLevel(0.9f), mSNR(NAN), mNoiseSigma(0),
+	  mFadeDepth(0), mFadeSamples(0), mBurstRate(0), mBurstLevel(0),
+	  mBurstSigma(0), mBurstSamples(0), mBurstThreshold(0), mOffset(0),
+	  mJitterSamples(0), mJitterLimit(inSampleRate / 20 - 1),
+	  mNoise(kChunkFloats)
+{
+}
+
+/******************************* SetSignalLevel *******************************/
+void ChannelModel::SetSignalLevel(
+	float	inLevel)
+{
+	mSignalLevel = inLevel;
+	UpdateNoise();
+}
+
+/********************************** SetNoise **********************************/
+void ChannelModel::SetNoise(
+	float	inSNR)
+{
+	mSNR = inSNR;
+	UpdateNoise();
+}
+
+/******************************** UpdateNoise *********************************/
+/*
+*	A real carrier of amplitude A has power A^2/2 spread over one float per
+*	sample, baseband has power A^2 spread over two, so in both cases the
+*	sigma per float for a linear SNR s is A/sqrt(2s).
+*/
+void ChannelModel::UpdateNoise(void)
+{
+	mNoiseSigma = isnan(mSNR) ? 0 :
+					mSignalLevel / sqrtf(2.0f * powf(10.0f, mSNR / 10.0f));
+	mBurstSigma = mBurstSamples ?
+					(mSignalLevel * powf(10.0f, mBurstLevel / 20.0f) / sqrtf(2.0f)) : 0;
+	mBurstSigma = sqrtf((mBurstSigma * mBurstSigma) + (mNoiseSigma * mNoiseSigma));
+}
+
+/********************************* SetFading **********************************/
+void ChannelModel::SetFading(
+	float	inDepth,
+	float	inPeriod)
+{
+	mFadeDepth = inDepth;
+	mFadeSamples = (inDepth > 0 && inPeriod > 0) ?
+					(uint32_t)lrint((double)inPeriod * mSampleRate) : 0;
+}
+
+/******************************** SetImpulses *********************************/
+void ChannelModel::SetImpulses(
+	float	inRate,
+	float	inLength,
+	float	inLevel)
+{
+	mBurstRate = inRate;
+	mBurstLevel = inLevel;
+	mBurstSamples = (inRate > 0 && inLength > 0) ?
+					(uint32_t)lrint((double)inLength * mSampleRate) : 0;
+	if (mBurstSamples)
+	{
+		// A slot is a burst when its hash is below the threshold.
+		double	probability = (double)inRate * mBurstSamples / mSampleRate;
+		mBurstThreshold = probability >= 1 ? 0xFFFFFFFF :
+							(uint32_t)(probability * 4294967296.0);
+	}
+	UpdateNoise();
+}
+
+/****************************** SetCarrierOffset ******************************/
+void ChannelModel::SetCarrierOffset(
+	float	inHz)
+{
+	mOffset = mChannels == 2 ? inHz : 0;
+}
+
+/******************************* SetEdgeJitter ********************************/
+void ChannelModel::SetEdgeJitter(
+	float	inJitter)
+{
+	mJitterSamples = inJitter > 0 ? (inJitter * mSampleRate) : 0;
+}
+
+/********************************** Process ***********************************/
+void ChannelModel::Process(
+	float*		ioBlock,
+	uint32_t	inSamples)
+{
+	while (inSamples)
+	{
+		uint32_t	count = kChunkFloats / mChannels;
+		uint64_t	counter = mSample * mChannels;	// Of the first float
+		uint32_t	toCounterWrap = (kCounterMask + 1) - (uint32_t)(counter & kCounterMask);
+		count = count < inSamples ? count : inSamples;
+		count = count < (toCounterWrap / mChannels) ? count : (toCounterWrap / mChannels);
+		float		gain = 1;
+		float		step = 0;
+		float		sigma = mNoiseSigma;
+		if (mFadeSamples)
+		{
+			uint64_t	knot = mSample / mFadeSamples;
+			uint32_t	position = (uint32_t)(mSample % mFadeSamples);
+			float		start = FadeGain(knot);
+			step = (FadeGain(knot + 1) - start) / mFadeSamples;
+			gain = start + step * position;
+			count = count < (mFadeSamples - position) ? count : (mFadeSamples - position);
+		}
+		if (mBurstSamples)
+		{
+			uint64_t	slot = mSample / mBurstSamples;
+			uint32_t	position = (uint32_t)(mSample % mBurstSamples);
+			if (InBurst(slot))
+			{
+				sigma = mBurstSigma;
+			}
+			count = count < (mBurstSamples - position) ? count : (mBurstSamples - position);
+		}
+		if (mOffset != 0)
+		{
+			Rotate(ioBlock, count);
+		}
+		if (sigma > 0)
+		{
+			FillNoise(Key(eNoiseStream, counter >> 31), (uint32_t)(counter & kCounterMask),
+						sigma, mNoise.data(), count * mChannels);
+		}
+		ApplyGain(ioBlock, sigma > 0 ? mNoise.data() : nullptr,
+					count * mChannels, mChannels, gain, step);
+		ioBlock += count * mChannels;
+		inSamples -= count;
+		mSample += count;
+	}
+}
+
+/*********************************** Rotate ***********************************/
+/*
+*	Multiplies the I/Q samples by e^(j*2*pi*offset*t).  The starting phase is
+*	recomputed from the stream position for each chunk so it doesn't drift.
+*/
+void ChannelModel::Rotate(
+	float*		ioBlock,
+	uint32_t	inSamples)
+{
+	const double	kTwoPi = 6.283185307179586476925;
+	double	angle = kTwoPi * fmod(mOffset * (double)mSample, (double)mSampleRate) / mSampleRate;
+	double	step = kTwoPi * mOffset / mSampleRate;
+	double	i = cos(angle);
+	double	q = sin(angle);
+	double	stepI = cos(step);
+	double	stepQ = sin(step);
+	for (uint32_t n = 0; n < inSamples; n++)
+	{
+		float	sampleI = ioBlock[n * 2];
+		float	sampleQ = ioBlock[(n * 2) + 1];
+		ioBlock[n * 2] = (float)((sampleI * i) - (sampleQ * q));
+		ioBlock[(n * 2) + 1] = (float)((sampleI * q) + (sampleQ * i));
+		double	nextI = (i * stepI) - (q * stepQ);
+		q = (i * stepQ) + (q * stepI);
+		i = nextI;
+	}
+}
+
+/********************************* EdgeOffset *********************************/
+int32_t ChannelModel::EdgeOffset(
+	uint64_t	inEdge) const
+{
+	int32_t	offset = 0;
+	if (mJitterSamples)
+	{
+		offset = (int32_t)lrintf(Gaussian(Key(eJitterStream, inEdge >> 31),
+									(uint32_t)(inEdge & kCounterMask)) * mJitterSamples);
+		offset = offset > mJitterLimit ? mJitterLimit :
+					(offset < -mJitterLimit ? -mJitterLimit : offset);
+	}
+	return(offset);
+}
+
+/************************************ Hash ************************************/
+/*
+*	A bijective 32 bit integer hash with low bias (lowbias32, C. Wellons.)
+*/
+uint32_t ChannelModel::Hash(
+	uint32_t	inValue)
+{
+	inValue ^= inValue >> 16;
+	inValue *= 0x7feb352d;
+	inValue ^= inValue >> 15;
+	inValue *= 0x846ca68b;
+	inValue ^= inValue >> 16;
+	return(inValue);
+}
+
+/********************************** Gaussian **********************************/
+/*
+*	Unit Gaussian number inCounter (less than 2^31) of the stream with key
+*	inKey.  Each uses the hashes of counters 2n and 2n+1.
+*/
+float ChannelModel::Gaussian(
+	uint32_t	inKey,
+	uint32_t	inCounter)
+{
+	float	gaussian;
+	FillNoise(inKey, inCounter, 1.0f, &gaussian, 1);
+	return(gaussian);
+}
+
+/************************************ Key *************************************/
+/*
+*	The hash key of a stream for counters inHigh * 2^31 to inHigh * 2^31 +
+*	2^31 - 1.  Counters are 64 bit, but only the low 31 bits are hashed per
+*	sample so that the vector lanes stay 32 bit.
+*/
+uint32_t ChannelModel::Key(
+	EStream		inStream,
+	uint64_t	inHigh) const
+{
+	uint32_t	key = Hash((uint32_t)mSeed ^ ((inStream + 1) * 0x9E3779B9));
+	key = Hash(key ^ (uint32_t)(mSeed >> 32));
+	return(Hash(key ^ (uint32_t)inHigh) ^ (uint32_t)(inHigh >> 32));
+}
+
+/********************************** FadeGain **********************************/
+/*
+*	The linear gain at fade knot inKnot, between 0 dB and the fade depth
+*	below.
+*/
+float ChannelModel::FadeGain(
+	uint64_t	inKnot) const
+{
+	uint32_t	uniform = Hash((uint32_t)(inKnot & kCounterMask) ^ Key(eFadeStream, inKnot >> 31));
+	return(powf(10.0f, -mFadeDepth * (float)(uniform / 4294967296.0) / 20.0f));
+}
+
+/********************************** InBurst ***********************************/
+bool ChannelModel::InBurst(
+	uint64_t	inSlot) const
+{
+	return(Hash((uint32_t)(inSlot & kCounterMask) ^ Key(eBurstStream, inSlot >> 31)) <
+				mBurstThreshold);
+}
+
+/******************************* InstructionSet *******************************/
+const char* ChannelModel::InstructionSet(void)
+{
+#if defined __AVX2__
+	return("AVX2");
+#elif defined __SSE2__
+	return("SSE2");
+#else
+	return("scalar");
+#endif
+}
+#endif
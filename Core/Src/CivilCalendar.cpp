@@ -0,0 +1,96 @@
+/*
+*	CivilCalendar.cpp, Copyright Jonathan Mackey 2026
+*
+*	Proleptic Gregorian calendar arithmetic.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "CivilCalendar.h"
+
+const uint32_t	CivilCalendar::kUnixEpochDays;
+const uint32_t	CivilCalendar::kYear2000Days;
+
+/******************************* DaysFromCivil ********************************/
+/*
+*	January and February are treated as months 13 and 14 of the previous year
+*	so that the leap day, if any, is the last day of the computational year.
+*/
+uint32_t CivilCalendar::DaysFromCivil(
+	uint16_t	inYear,
+	uint8_t		inMonth,
+	uint8_t		inDay)
+{
+	uint32_t	janFeb = inMonth <= 2;
+	uint32_t	year = (uint32_t)inYear - janFeb;
+	uint32_t	month = janFeb ? (inMonth + 12) : inMonth;
+	uint32_t	century = year / 100;
+	// Days to the start of the year: 365.25 days per year less the century
+	// years that are not leap years.
+	uint32_t	yearDays = ((1461 * year) / 4) - century + (century / 4);
+	// Days from March 1st to the start of the month (Mar = 3 ... Feb = 14)
+	uint32_t	monthDays = ((979 * month) - 2919) / 32;
+	return(yearDays + monthDays + inDay - 1);
+}
+
+/******************************* CivilFromDays ********************************/
+void CivilCalendar::CivilFromDays(
+	uint32_t	inDays,
+	uint16_t&	outYear,
+	uint8_t&	outMonth,
+	uint8_t&	outDay)
+{
+	// Century and day of century
+	uint32_t	n1 = (4 * inDays) + 3;
+	uint32_t	century = n1 / 146097;
+	uint32_t	n2 = (n1 % 146097) | 3;
+	/*
+	*	Year of century and day of year.  2939745/2^32 approximates 1/1461
+	*	(4 years of days) closely enough that the high word of the product is
+	*	the year and the low word is the scaled remainder.
+	*/
+	uint64_t	p2 = (uint64_t)2939745 * n2;
+	uint32_t	yearOfCentury = (uint32_t)(p2 >> 32);
+	uint32_t	dayOfYear = ((uint32_t)p2) / 2939745 / 4;
+	// Month and day, March = 3 ... February = 14
+	uint32_t	n3 = (2141 * dayOfYear) + 197913;
+	uint32_t	month = n3 >> 16;
+	uint32_t	day = (n3 & 0xFFFF) / 2141;
+	// January and February belong to the following civil year.
+	uint32_t	janFeb = dayOfYear >= 306;
+	outYear = (100 * century) + yearOfCentury + janFeb;
+	outMonth = janFeb ? (month - 12) : month;
+	outDay = day + 1;
+}
+
+/********************************* DayOfYear **********************************/
+uint16_t CivilCalendar::DayOfYear(
+	uint16_t	inYear,
+	uint8_t		inMonth,
+	uint8_t		inDay)
+{
+	/*
+	*	(275 * month)/9 - 30 is the number of days preceding the month in a
+	*	common year when the month is January or February.  For the months
+	*	that follow February, 2 days are subtracted for a common year and
+	*	1 day for a leap year.
+	*/
+	uint16_t	afterFeb = (inMonth + 9) / 12;
+	return(((275 * inMonth) / 9) -
+			(afterFeb * (2 - IsLeapYear(inYear))) + inDay - 30);
+}
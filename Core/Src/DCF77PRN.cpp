@@ -0,0 +1,107 @@
+/*
+*	DCF77PRN.cpp, Copyright Jonathan Mackey 2026
+*
+*	The DCF77 pseudo-random phase modulation.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "DCF77PRN.h"
+#if defined __linux__ || defined __MACH__
+#include <math.h>
+#endif
+
+constexpr float	DCF77PRN::kDeviation;
+
+/********************************** Sequence **********************************/
+constexpr DCF77PRN::SChips DCF77PRN::Sequence(void)
+{
+	/*
+	*	Stage n is bit n - 1.  The output is stage 9 and the feedback into
+	*	stage 1 is stage 5 XOR stage 9.  The 512th chip stays 0.
+	*/
+	SChips		chips = {};
+	uint32_t	state = 0x1FF;
+	for (uint32_t i = 0; i < (kChips - 1); i++)
+	{
+		uint32_t	output = (state >> 8) & 1;
+		chips.bits[i >> 5] |= output << (i & 31);
+		state = ((state << 1) | (output ^ ((state >> 4) & 1))) & 0x1FF;
+	}
+	return(chips);
+}
+
+/*
+*	Constant initialized, so it's ready before any code runs and is never
+*	written, whichever thread first uses it.
+*/
+constexpr DCF77PRN::SChips	DCF77PRN::sChips = Sequence();
+
+/********************************* ChipStart **********************************/
+uint32_t DCF77PRN::ChipStart(
+	uint32_t	inIndex,
+	uint32_t	inSampleRate)
+{
+	return((uint32_t)(((uint64_t)inSampleRate * kStartMs) / 1000) +
+			(uint32_t)((((uint64_t)inIndex * kCyclesPerChip * inSampleRate) +
+						(kCarrierHz / 2)) / kCarrierHz));
+}
+
+#if defined __linux__ || defined __MACH__
+/********************************* Correlate **********************************/
+float DCF77PRN::Correlate(
+	const float*	inIQ,
+	uint32_t		inSampleRate,
+	int32_t			inLag)
+{
+	double		referenceI = 0;
+	double		referenceQ = 0;
+	uint32_t	sample = 0;
+	for (uint32_t end = ChipStart(0, inSampleRate); sample < end; sample++)
+	{
+		referenceI += inIQ[sample * 2];
+		referenceQ += inIQ[(sample * 2) + 1];
+	}
+	double	total = 0;
+	double	magnitude = 0;
+	for (uint32_t i = 0; i < kChips; i++)
+	{
+		double	chipI = 0;
+		double	chipQ = 0;
+		for (uint32_t end = ChipStart(i + 1, inSampleRate); sample < end; sample++)
+		{
+			chipI += inIQ[sample * 2];
+			chipQ += inIQ[(sample * 2) + 1];
+		}
+		/*
+		*	The imaginary part of the chip times the conjugate reference has
+		*	the sign of the chip's phase.  Chips shifted past either end of
+		*	the sequence count toward the magnitude but not the total.
+		*/
+		double	phase = (chipQ * referenceI) - (chipI * referenceQ);
+		int32_t	reference = (int32_t)i + inLag;
+		if (reference >= 0 &&
+			reference < (int32_t)kChips)
+		{
+			total += Chip(reference) ? -phase : phase;
+		}
+		magnitude += fabs(phase);
+	}
+	return(magnitude > 0 ? (float)(total / magnitude) : 0);
+}
+#endif
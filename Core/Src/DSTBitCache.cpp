@@ -0,0 +1,64 @@
+/*
+*	DSTBitCache.cpp, Copyright Jonathan Mackey 2026
+*
+*	The WWVB DST status bits (57 and 58) for every UTC day of a year.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "DSTBitCache.h"
+#include "CivilCalendar.h"
+#include <string.h>
+
+/******************************** DSTBitCache *********************************/
+DSTBitCache::DSTBitCache(void)
+	: mRule(nullptr), mYear(0)
+{
+	mUSRule.Parse("EST5EDT,M3.2.0,M11.1.0");
+}
+
+/****************************** SetTimeZoneRule *******************************/
+void DSTBitCache::SetTimeZoneRule(
+	TimeZoneRule*	inRule)
+{
+	mRule = inRule;
+	Invalidate();
+}
+
+/************************************ Load ************************************/
+void DSTBitCache::Load(
+	uint16_t	inYear)
+{
+	TimeZoneRule&	rule = Rule();
+	memset(mBits, 0, sizeof(mBits));
+	if (rule.HasDST())
+	{
+		uint16_t	days = CivilCalendar::IsLeapYear(inYear) ? 366 : 365;
+		time32_t	dayStart = (CivilCalendar::DaysFromCivil(inYear, 1, 1) -
+									CivilCalendar::kUnixEpochDays) * 86400;
+		uint8_t		dstAtStart = rule.IsDST(dayStart);
+		for (uint16_t day = 0; day < days; day++)
+		{
+			dayStart += 86400;
+			uint8_t	dstAtEnd = rule.IsDST(dayStart);
+			mBits[day >> 2] |= ((dstAtEnd << 1) | dstAtStart) << ((day & 3) * 2);
+			dstAtStart = dstAtEnd;
+		}
+	}
+	mYear = inYear;
+}
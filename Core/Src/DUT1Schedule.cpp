@@ -0,0 +1,186 @@
+/*
+*	DUT1Schedule.cpp, Copyright Jonathan Mackey 2026
+*
+*	Schedule of DUT1 (UT1 - UTC in tenths of a second.)
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "DUT1Schedule.h"
+#include "CivilCalendar.h"
+
+/*
+*	From IERS Bulletin D.  The first entry is the start of the table.  Add
+*	entries here as bulletins are published, or send them via the UART.
+*/
+const DUT1Schedule::SDUT1	DUT1Schedule::kDUT1Schedule[] =
+{
+	{0, 0}
+};
+
+const DUT1Schedule::SDUT1*	DUT1Schedule::sTable = kDUT1Schedule;
+uint8_t			DUT1Schedule::sCount = sizeof(kDUT1Schedule)/sizeof(SDUT1);
+uint8_t			DUT1Schedule::sCursor = sizeof(kDUT1Schedule)/sizeof(SDUT1) - 1;
+DUT1Schedule::SDUT1	DUT1Schedule::sLoaded[kMaxEntries];
+
+/********************************** AddEntry **********************************/
+bool DUT1Schedule::AddEntry(
+	time32_t	inTime,
+	int8_t		inTenths)
+{
+	bool	added = inTenths >= -9 && inTenths <= 9;
+	if (added)
+	{
+		/*
+		*	The built in table is in flash, so it's first copied to RAM.
+		*/
+		if (sTable != sLoaded)
+		{
+			for (uint8_t i = 0; i < sCount; i++)
+			{
+				sLoaded[i] = sTable[i];
+			}
+			sTable = sLoaded;
+		}
+		uint8_t	index = 0;
+		while (index < sCount && sLoaded[index].time < inTime)
+		{
+			index++;
+		}
+		if (index < sCount &&
+			sLoaded[index].time == inTime)
+		{
+			sLoaded[index].tenths = inTenths;
+		} else
+		{
+			if (sCount == kMaxEntries)
+			{
+				// Drop the oldest entry
+				for (uint8_t i = 1; i < sCount; i++)
+				{
+					sLoaded[i - 1] = sLoaded[i];
+				}
+				sCount--;
+				if (index)
+				{
+					index--;
+				}
+			}
+			for (uint8_t i = sCount; i > index; i--)
+			{
+				sLoaded[i] = sLoaded[i - 1];
+			}
+			sLoaded[index].time = inTime;
+			sLoaded[index].tenths = inTenths;
+			sCount++;
+		}
+		sCursor = 0;
+	}
+	return(added);
+}
+
+/******************************* ParseSentence ********************************/
+bool DUT1Schedule::ParseSentence(
+	const char*	inSentence,
+	time32_t&	outTime,
+	int8_t&		outTenths)
+{
+	static const char	kPreamble[] = "$PDUT1,";
+	bool	valid = true;
+	uint8_t	crc = 0;
+	uint8_t	i = 0;
+	for (; kPreamble[i] && valid; i++)
+	{
+		valid = inSentence[i] == kPreamble[i];
+		crc ^= i ? (uint8_t)inSentence[i] : 0;
+	}
+	const char*	sentencePtr = &inSentence[i];
+	uint32_t	date = 0;
+	for (i = 0; i < 8 && valid; i++)
+	{
+		uint8_t	digit = (uint8_t)(sentencePtr[i] - '0');
+		valid = digit <= 9;
+		date = (date * 10) + digit;
+		crc ^= (uint8_t)sentencePtr[i];
+	}
+	if (valid)
+	{
+		sentencePtr += 8;
+		valid = *sentencePtr == ',';
+		crc ^= (uint8_t)*(sentencePtr++);
+	}
+	bool	negative = false;
+	if (valid &&
+		(*sentencePtr == '-' || *sentencePtr == '+'))
+	{
+		negative = *sentencePtr == '-';
+		crc ^= (uint8_t)*(sentencePtr++);
+	}
+	uint8_t	tenths = 0;
+	if (valid)
+	{
+		tenths = (uint8_t)(*sentencePtr - '0');
+		valid = tenths <= 9 && sentencePtr[1] == '*';
+		crc ^= (uint8_t)*sentencePtr;
+		sentencePtr += 2;
+	}
+	uint8_t	expectedCRC = 0;
+	for (i = 0; i < 2 && valid; i++)
+	{
+		char	thisChar = sentencePtr[i];
+		uint8_t	nibble = (uint8_t)(thisChar - '0');
+		if (nibble > 9)
+		{
+			nibble = (uint8_t)((thisChar | 0x20) - 'a' + 10);
+			valid = nibble >= 10 && nibble <= 15;
+		}
+		expectedCRC = (uint8_t)((expectedCRC << 4) + nibble);
+	}
+	if (valid)
+	{
+		SUnixTimeComponents	components;
+		components.year = (uint16_t)(date / 10000);
+		components.month = (uint8_t)((date / 100) % 100);
+		components.day = (uint8_t)(date % 100);
+		components.hour = components.minute = components.second = 0;
+		valid = crc == expectedCRC &&
+				components.month >= 1 && components.month <= 12 &&
+				components.day >= 1 &&
+				components.day <= CivilCalendar::DaysInMonth(components.month, components.year);
+		if (valid)
+		{
+			outTime = UnixTimeConverter<time32_t>::FromComponents(components);
+			outTenths = negative ? -(int8_t)tenths : (int8_t)tenths;
+		}
+	}
+	return(valid);
+}
+
+/********************************* MoveCursor *********************************/
+void DUT1Schedule::MoveCursor(
+	time32_t	inUTC)
+{
+	while (sCursor > 0 && inUTC < sTable[sCursor].time)
+	{
+		sCursor--;
+	}
+	while ((sCursor + 1) < sCount && inUTC >= sTable[sCursor + 1].time)
+	{
+		sCursor++;
+	}
+}
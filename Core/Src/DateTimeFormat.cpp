@@ -0,0 +1,58 @@
+/*
+*	DateTimeFormat.cpp, Copyright Jonathan Mackey 2026
+*
+*	strftime-like date/time formatting where the pattern is parsed at compile
+*	time.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "DateTimeFormat.h"
+
+const char	DateTimeFormatter::kDigitPairs[] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+const char	DateTimeFormatter::kMonthAbbr[] = "JANFEBMARAPRMAYJUNJULAUGSEPOCTNOVDEC";
+const char	DateTimeFormatter::kDayOfWeekAbbr[] = "SUNMONTUEWEDTHUFRISAT";
+
+/******************************** WriteUint16 *********************************/
+uint8_t DateTimeFormatter::WriteUint16(
+	uint16_t	inValue,
+	char*		outStr)
+{
+	uint8_t	digits = inValue >= 10000 ? 5 :
+						inValue >= 1000 ? 4 :
+							inValue >= 100 ? 3 :
+								inValue >= 10 ? 2 : 1;
+	char*	str = &outStr[digits];
+	*str = 0;
+	for (; inValue >= 100; inValue /= 100)
+	{
+		str -= 2;
+		Write2Digits(inValue % 100, str);
+	}
+	if (inValue >= 10)
+	{
+		Write2Digits(inValue, str - 2);
+	} else
+	{
+		str[-1] = '0' + inValue;
+	}
+	return(digits);
+}
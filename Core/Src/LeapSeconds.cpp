@@ -0,0 +1,292 @@
+/*
+*	LeapSeconds.cpp, Copyright Jonathan Mackey 2026
+*
+*	Leap second table with TAI-UTC and upcoming leap second queries.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "LeapSeconds.h"
+#include "CivilCalendar.h"
+#if defined __linux__ || defined __MACH__
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+/*
+*	From leap-seconds.list.  The first entry is the start of the table rather
+*	than a leap second.  When adding a leap second, also update sExpires.
+*/
+const LeapSeconds::SLeapSecond	LeapSeconds::kLeapSeconds[] =
+{
+	{63072000, 10},	// 1-JAN-1972
+	{78796800, 11},	// 1-JUL-1972
+	{94694400, 12},	// 1-JAN-1973
+	{126230400, 13},	// 1-JAN-1974
+	{157766400, 14},	// 1-JAN-1975
+	{189302400, 15},	// 1-JAN-1976
+	{220924800, 16},	// 1-JAN-1977
+	{252460800, 17},	// 1-JAN-1978
+	{283996800, 18},	// 1-JAN-1979
+	{315532800, 19},	// 1-JAN-1980
+	{362793600, 20},	// 1-JUL-1981
+	{394329600, 21},	// 1-JUL-1982
+	{425865600, 22},	// 1-JUL-1983
+	{489024000, 23},	// 1-JUL-1985
+	{567993600, 24},	// 1-JAN-1988
+	{631152000, 25},	// 1-JAN-1990
+	{662688000, 26},	// 1-JAN-1991
+	{709948800, 27},	// 1-JUL-1992
+	{741484800, 28},	// 1-JUL-1993
+	{773020800, 29},	// 1-JUL-1994
+	{820454400, 30},	// 1-JAN-1996
+	{867715200, 31},	// 1-JUL-1997
+	{915148800, 32},	// 1-JAN-1999
+	{1136073600, 33},	// 1-JAN-2006
+	{1230768000, 34},	// 1-JAN-2009
+	{1341100800, 35},	// 1-JUL-2012
+	{1435708800, 36},	// 1-JUL-2015
+	{1483228800, 37}	// 1-JAN-2017
+};
+
+const LeapSeconds::SLeapSecond*	LeapSeconds::sTable = kLeapSeconds;
+uint8_t			LeapSeconds::sCount = sizeof(kLeapSeconds)/sizeof(SLeapSecond);
+// Start on the last entry, the most likely place for the current time.
+uint8_t			LeapSeconds::sCursor = sizeof(kLeapSeconds)/sizeof(SLeapSecond) - 1;
+time32_t		LeapSeconds::sNextMonthStart;
+time32_t		LeapSeconds::sExpires = 1782604800;	// 28-JUN-2026
+uint8_t			LeapSeconds::sAddedCount;
+LeapSeconds::SLeapSecond	LeapSeconds::sLoaded[kMaxLoadedEntries];
+
+/******************************** TAIMinusUTC *********************************/
+int16_t LeapSeconds::TAIMinusUTC(
+	time32_t	inUTC)
+{
+	Seek(inUTC);
+	return(sTable[sCursor].taiMinusUTC);
+}
+
+/****************************** LeapSecondAtEOM *******************************/
+int8_t LeapSeconds::LeapSecondAtEOM(
+	time32_t	inUTC)
+{
+	Seek(inUTC);
+	int8_t	delta = 0;
+	if ((sCursor + 1) < sCount &&
+		inUTC >= sNextMonthStart)
+	{
+		delta = sTable[sCursor + 1].taiMinusUTC - sTable[sCursor].taiMinusUTC;
+	}
+	return(delta);
+}
+
+/******************************* NextLeapSecond *******************************/
+bool LeapSeconds::NextLeapSecond(
+	time32_t	inUTC,
+	time32_t&	outTime,
+	int8_t&		outDelta)
+{
+	Seek(inUTC);
+	bool	scheduled = (sCursor + 1) < sCount;
+	if (scheduled)
+	{
+		outTime = sTable[sCursor + 1].time;
+		outDelta = sTable[sCursor + 1].taiMinusUTC - sTable[sCursor].taiMinusUTC;
+	}
+	return(scheduled);
+}
+
+/********************************* MoveCursor *********************************/
+void LeapSeconds::MoveCursor(
+	time32_t	inUTC)
+{
+	while (sCursor > 0 && inUTC < sTable[sCursor].time)
+	{
+		sCursor--;
+	}
+	while ((sCursor + 1) < sCount && inUTC >= sTable[sCursor + 1].time)
+	{
+		sCursor++;
+	}
+	if ((sCursor + 1) < sCount)
+	{
+		/*
+		*	The leap second is the last second of the month preceding the
+		*	next entry.  Cache the start of that month.
+		*/
+		uint16_t	year;
+		uint8_t		month, day;
+		UnixTimeConverter<time32_t>::DateComponents(sTable[sCursor + 1].time - 1,
+														year, month, day);
+		sNextMonthStart = (CivilCalendar::DaysFromCivil(year, month, 1) -
+								CivilCalendar::kUnixEpochDays) * 86400;
+	}
+}
+
+/******************************* AddLeapSecond ********************************/
+bool LeapSeconds::AddLeapSecond(
+	time32_t	inTime,
+	int8_t		inDelta)
+{
+	uint16_t	year;
+	uint8_t		month, day;
+	UnixTimeConverter<time32_t>::DateComponents(inTime, year, month, day);
+	bool	added = (inDelta == 1 || inDelta == -1) &&
+					(inTime % 86400) == 0 &&
+					day == 1 &&
+					inTime > sTable[sCount - 1].time &&
+					sCount < kMaxLoadedEntries;
+	if (added)
+	{
+		/*
+		*	The built in table is in flash, so it's first copied to RAM.
+		*/
+		if (sTable != sLoaded)
+		{
+			for (uint8_t i = 0; i < sCount; i++)
+			{
+				sLoaded[i] = sTable[i];
+			}
+			sTable = sLoaded;
+		}
+		sLoaded[sCount].time = inTime;
+		sLoaded[sCount].taiMinusUTC = sLoaded[sCount - 1].taiMinusUTC + inDelta;
+		sCount++;
+		sAddedCount++;
+		MoveCursor(sTable[sCursor].time);	// Updates sNextMonthStart
+	}
+	return(added);
+}
+
+/*************************** RemoveAddedLeapSeconds ***************************/
+void LeapSeconds::RemoveAddedLeapSeconds(void)
+{
+	if (sAddedCount)
+	{
+		sCount -= sAddedCount;
+		sAddedCount = 0;
+		if (sCursor >= sCount)
+		{
+			sCursor = sCount - 1;
+		}
+		MoveCursor(sTable[sCursor].time);
+	}
+}
+
+/******************************* ParseSentence ********************************/
+bool LeapSeconds::ParseSentence(
+	const char*	inSentence,
+	int8_t&		outDelta)
+{
+	static const char	kPreamble[] = "$PLEAP,";
+	bool	valid = true;
+	uint8_t	crc = 0;
+	uint8_t	i = 0;
+	for (; kPreamble[i] && valid; i++)
+	{
+		valid = inSentence[i] == kPreamble[i];
+		crc ^= i ? (uint8_t)inSentence[i] : 0;
+	}
+	const char*	sentencePtr = &inSentence[i];
+	if (valid)
+	{
+		valid = (sentencePtr[0] == '+' || sentencePtr[0] == '-') &&
+				sentencePtr[1] == '1' &&
+				sentencePtr[2] == '*';
+		crc ^= (uint8_t)sentencePtr[0] ^ (uint8_t)'1';
+	}
+	uint8_t	expectedCRC = 0;
+	for (i = 3; i < 5 && valid; i++)
+	{
+		char	thisChar = sentencePtr[i];
+		uint8_t	nibble = (uint8_t)(thisChar - '0');
+		if (nibble > 9)
+		{
+			nibble = (uint8_t)((thisChar | 0x20) - 'a' + 10);
+			valid = nibble >= 10 && nibble <= 15;
+		}
+		expectedCRC = (uint8_t)((expectedCRC << 4) + nibble);
+	}
+	valid = valid && crc == expectedCRC;
+	if (valid)
+	{
+		outDelta = sentencePtr[0] == '-' ? -1 : 1;
+	}
+	return(valid);
+}
+
+#if defined __linux__ || defined __MACH__
+/******************************** LoadIERSList ********************************/
+bool LeapSeconds::LoadIERSList(
+	const char*	inPath)
+{
+	const int64_t	kNTPToUnix = 2208988800;	// Seconds from 1900 to 1970
+	uint8_t		count = 0;
+	time32_t	expires = 0;
+	FILE*	file = fopen(inPath, "r");
+	if (file)
+	{
+		char	line[256];
+		while (fgets(line, sizeof(line), file))
+		{
+			char*	end;
+			if (line[0] == '#')
+			{
+				// "#@ <NTP time>" is the expiration date
+				if (line[1] == '@')
+				{
+					int64_t	ntpTime = strtoll(&line[2], nullptr, 10);
+					if (ntpTime > kNTPToUnix)
+					{
+						expires = (time32_t)(ntpTime - kNTPToUnix);
+					}
+				}
+				continue;
+			}
+			int64_t	ntpTime = strtoll(line, &end, 10);
+			if (end == line)
+			{
+				continue;	// Blank line
+			}
+			char*	offsetStr = end;
+			long	taiMinusUTC = strtol(offsetStr, &end, 10);
+			if (end != offsetStr &&
+				ntpTime >= kNTPToUnix &&
+				(ntpTime - kNTPToUnix) <= 0xFFFFFFFF &&
+				count < kMaxLoadedEntries &&
+				(count == 0 || (ntpTime - kNTPToUnix) > sLoaded[count - 1].time))
+			{
+				sLoaded[count].time = (time32_t)(ntpTime - kNTPToUnix);
+				sLoaded[count].taiMinusUTC = (int16_t)taiMinusUTC;
+				count++;
+			}
+		}
+		fclose(file);
+	}
+	if (count)
+	{
+		sTable = sLoaded;
+		sCount = count;
+		sCursor = 0;
+		sExpires = expires;
+		sAddedCount = 0;
+		MoveCursor(sLoaded[count - 1].time);
+	}
+	return(count != 0);
+}
+#endif
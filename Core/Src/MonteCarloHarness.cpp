@@ -0,0 +1,317 @@
+/*
+*	MonteCarloHarness.cpp, Copyright Jonathan Mackey 2026
+*
+*	Measures a decoder's time to lock and frame error rate over many
+*	independent trials.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "MonteCarloHarness.h"
+#if defined __linux__ || defined __MACH__
+#include "WWVBSynthesizer.h"
+#include "ChannelModel.h"
+#include "TimeCodeEncoder.h"
+#include "TimeCodeDecoder.h"
+#include <mutex>
+#include <thread>
+
+// Trials are taken kBatch at a time, enough to keep the shared counter cold.
+static const uint32_t	kBatch = 4;
+// Trials start between 1-JAN-2001 and 1-JAN-2099.
+static const time32_t	kFirstStart = 978307200;
+static const time32_t	kStartRange = 4070908800U - 978307200;
+static std::mutex		sEncodeLock;
+
+/****************************** CreateReference *******************************/
+static void* CreateReference(
+	const STimeCodeStation&	inStation,
+	uint32_t				inSampleRate)
+{
+	return(new TimeCodeDecoder(inStation, inSampleRate));
+}
+
+/****************************** DestroyReference ******************************/
+static void DestroyReference(
+	void*	inDecoder)
+{
+	delete (TimeCodeDecoder*)inDecoder;
+}
+
+/****************************** ProcessReference ******************************/
+static bool ProcessReference(
+	void*			inDecoder,
+	const float*	inSamples,
+	uint32_t		inCount,
+	time32_t&		outMinute)
+{
+	return(((TimeCodeDecoder*)inDecoder)->Process(inSamples, inCount, outMinute));
+}
+
+const SDecoderUnderTest	MonteCarloHarness::kReferenceDecoder =
+{
+	"reference", CreateReference, DestroyReference, ProcessReference
+};
+
+/******************************* CollectSamples *******************************/
+/*
+*	The synthesizer's sink, appends to the std::vector<float> inContext.
+*/
+static bool CollectSamples(
+	void*		inContext,
+	const void*	inData,
+	size_t		inBytes)
+{
+	std::vector<float>*	samples = (std::vector<float>*)inContext;
+	samples->insert(samples->end(), (const float*)inData,
+						(const float*)inData + (inBytes / sizeof(float)));
+	return(true);
+}
+
+/********************************* TrialSeed **********************************/
+/*
+*	The ChannelModel seed of a trial (the SplitMix64 finalizer.)
+*/
+static uint64_t TrialSeed(
+	uint64_t	inSeed,
+	uint32_t	inTrial)
+{
+	uint64_t	seed = inSeed + ((uint64_t)(inTrial + 1) * 0x9E3779B97F4A7C15ULL);
+	seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+	return(seed ^ (seed >> 31));
+}
+
+/*********************************** Merge ************************************/
+void MonteCarloHarness::SResults::Merge(
+	const SResults&	inResults)
+{
+	trials += inResults.trials;
+	frames += inResults.frames;
+	correct += inResults.correct;
+	wrong += inResults.wrong;
+	lockSeconds += inResults.lockSeconds;
+	if (framesToLock.size() < inResults.framesToLock.size())
+	{
+		framesToLock.resize(inResults.framesToLock.size());
+	}
+	for (size_t i = 0; i < inResults.framesToLock.size(); i++)
+	{
+		framesToLock[i] += inResults.framesToLock[i];
+	}
+}
+
+/*********************************** Locked ***********************************/
+uint32_t MonteCarloHarness::SResults::Locked(void) const
+{
+	uint32_t	locked = 0;
+	for (uint32_t count : framesToLock)
+	{
+		locked += count;
+	}
+	return(locked);
+}
+
+/******************************** FramesToLock ********************************/
+uint32_t MonteCarloHarness::SResults::FramesToLock(
+	float	inFraction) const
+{
+	uint32_t	locked = 0;
+	for (size_t i = 0; i < framesToLock.size(); i++)
+	{
+		locked += framesToLock[i];
+		if (locked &&
+			locked >= (inFraction * trials))
+		{
+			return((uint32_t)(i + 1));
+		}
+	}
+	return(0);
+}
+
+/****************************** MeanFramesToLock ******************************/
+/*
+*	Of the trials that locked.
+*/
+double MonteCarloHarness::SResults::MeanFramesToLock(void) const
+{
+	uint64_t	total = 0;
+	uint32_t	locked = 0;
+	for (size_t i = 0; i < framesToLock.size(); i++)
+	{
+		total += (uint64_t)framesToLock[i] * (i + 1);
+		locked += framesToLock[i];
+	}
+	return(locked ? ((double)total / locked) : 0);
+}
+
+/***************************** MonteCarloHarness ******************************/
+MonteCarloHarness::MonteCarloHarness(
+	const STimeCodeStation&	inStation,
+	uint32_t				inSampleRate)
+	: mStation(inStation), mSampleRate(inSampleRate),
+	  mDecoder(&kReferenceDecoder), mFrames(10), mThreads(0)
+{
+}
+
+/********************************** Threads ***********************************/
+uint32_t MonteCarloHarness::Threads(void) const
+{
+	uint32_t	threads = mThreads;
+	if (threads == 0)
+	{
+		threads = std::thread::hardware_concurrency();
+	}
+	return(threads ? threads : 1);
+}
+
+/************************************ Run *************************************/
+MonteCarloHarness::SResults MonteCarloHarness::Run(
+	const SImpairments&	inImpairments,
+	uint64_t			inSeed,
+	uint32_t			inTrials,
+	uint32_t			inFirstTrial)
+{
+	uint32_t	threads = Threads();
+	if (threads > ((inTrials + kBatch - 1) / kBatch))
+	{
+		threads = inTrials ? ((inTrials + kBatch - 1) / kBatch) : 1;
+	}
+	SWork	work;
+	work.impairments = &inImpairments;
+	work.seed = inSeed;
+	work.trials = inTrials;
+	work.firstTrial = inFirstTrial;
+	work.next = 0;
+	std::vector<SResults>		results(threads);
+	std::vector<std::thread>	workers;
+	for (uint32_t i = 1; i < threads; i++)
+	{
+		workers.emplace_back(&MonteCarloHarness::Worker, this, &work, &results[i]);
+	}
+	Worker(&work, &results[0]);
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	/*
+	*	The statistics are integer sums, so the merge order doesn't matter.
+	*/
+	for (uint32_t i = 1; i < threads; i++)
+	{
+		results[0].Merge(results[i]);
+	}
+	return(results[0]);
+}
+
+/*********************************** Worker ***********************************/
+void MonteCarloHarness::Worker(
+	SWork*		ioWork,
+	SResults*	outResults)
+{
+	std::vector<float>	samples;
+	*outResults = SResults();
+	outResults->framesToLock.resize(mFrames);
+	uint32_t	batch;
+	while ((batch = ioWork->next.fetch_add(kBatch)) < ioWork->trials)
+	{
+		uint32_t	end = (batch + kBatch) < ioWork->trials ? (batch + kBatch) : ioWork->trials;
+		for (uint32_t trial = batch; trial < end; trial++)
+		{
+			RunTrial(*ioWork->impairments, ioWork->seed, ioWork->firstTrial + trial,
+						samples, *outResults);
+		}
+	}
+}
+
+/********************************** RunTrial **********************************/
+void MonteCarloHarness::RunTrial(
+	const SImpairments&	inImpairments,
+	uint64_t			inSeed,
+	uint32_t			inTrial,
+	std::vector<float>&	ioSamples,
+	SResults&			ioResults)
+{
+	uint64_t	seed = TrialSeed(inSeed, inTrial);
+	time32_t	start = kFirstStart + (time32_t)((seed >> 32) % kStartRange);
+	// The first minute is partial unless the trial starts on second 0.
+	time32_t	firstFrame = (start % 60) ? (start - (start % 60) + 60) : start;
+	time32_t	end = firstFrame + (mFrames * 60);
+	ChannelModel	channel(mSampleRate, 2, seed);
+	channel.SetNoise(inImpairments.snr);
+	channel.SetFading(inImpairments.fadeDepth, inImpairments.fadePeriod);
+	channel.SetImpulses(inImpairments.burstRate, inImpairments.burstLength,
+						inImpairments.burstLevel);
+	channel.SetCarrierOffset(inImpairments.offset);
+	channel.SetEdgeJitter(inImpairments.jitter);
+	WWVBSynthesizer	synthesizer(mSampleRate, 0, WWVBSynthesizer::eBasebandCF32, mStation);
+	synthesizer.SetChannel(&channel);
+	synthesizer.SetSink(CollectSamples, &ioSamples);
+	TimeCodeEncoder	encoder(mStation);
+	STimeCodeFrame	frame = {0, 0};
+	void*		decoder = mDecoder->create(mStation, mSampleRate);
+	uint32_t	wholeFrames = 0;
+	bool		locked = false;
+	for (time32_t time = start; time < end; time++)
+	{
+		uint32_t	second = time % 60;
+		if (time == start ||
+			second == 0)
+		{
+			std::lock_guard<std::mutex>	lock(sEncodeLock);
+			frame = encoder.Encode(time);
+		}
+		ioSamples.clear();
+		synthesizer.WriteSecond(frame.GetSymbol(second), second, 0);
+		synthesizer.Flush();
+		if (second == 59 &&
+			time > firstFrame)
+		{
+			wholeFrames++;
+		}
+		time32_t	minute;
+		if (mDecoder->process(decoder, ioSamples.data(),
+								(uint32_t)(ioSamples.size() / 2), minute))
+		{
+			/*
+			*	The frame that most recently ended.  Jitter can delay the
+			*	end of its last tenth into the next second.
+			*/
+			time32_t	ended = (time + 1) - ((time + 1) % 60) - 60;
+			if (minute == ended &&
+				(time - ended) <= 60 &&
+				ended >= firstFrame)
+			{
+				ioResults.correct++;
+				if (!locked)
+				{
+					locked = true;
+					ioResults.framesToLock[wholeFrames - 1]++;
+					ioResults.lockSeconds += (time - start) + 1;
+				}
+			} else
+			{
+				ioResults.wrong++;
+			}
+		}
+	}
+	mDecoder->destroy(decoder);
+	ioResults.trials++;
+	ioResults.frames += mFrames;
+}
+#endif
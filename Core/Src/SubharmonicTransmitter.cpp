@@ -0,0 +1,176 @@
+/*
+*	SubharmonicTransmitter.cpp, Copyright Jonathan Mackey 2026
+*
+*	Sends the WWVB time code through a sound card as the third harmonic of
+*	a square wave.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "SubharmonicTransmitter.h"
+#if defined __linux__ || defined __MACH__
+#include <thread>
+
+/*************************** SubharmonicTransmitter ***************************/
+SubharmonicTransmitter::SubharmonicTransmitter(
+	uint32_t	inSampleRate,
+	uint32_t	inCarrierHz,
+	uint32_t	inBufferMs)
+	: mSynthesizer(inSampleRate, inCarrierHz, WWVBSynthesizer::eSubharmonicS16),
+	  mRing(((uint64_t)inSampleRate * inBufferMs / 1000) * sizeof(int16_t)),
+	  mSink(WWVBSynthesizer::FileSink), mSinkContext(stdout), mLead(0),
+	  mPaced(true), mStartTime(0), mProducerDone(false), mSinkFailed(false)
+{
+	mSynthesizer.SetSink(RingSink, this);
+	mLatency = SLatency();
+}
+
+/********************************** SetSink ***********************************/
+void SubharmonicTransmitter::SetSink(
+	SampleSink	inSink,
+	void*		inContext)
+{
+	mSink = inSink;
+	mSinkContext = inContext;
+}
+
+/************************************ Run *************************************/
+bool SubharmonicTransmitter::Run(
+	uint32_t	inSeconds,
+	bool		inPhaseModulation)
+{
+	/*
+	*	Start on the next whole second of the host clock (UTC.)  That second
+	*	is located on the steady clock once, so the pacing isn't affected by
+	*	later steps of the host clock.
+	*/
+	std::chrono::system_clock::time_point	wallNow = std::chrono::system_clock::now();
+	Clock::time_point	steadyNow = Clock::now();
+	std::chrono::seconds	sinceEpoch =
+		std::chrono::duration_cast<std::chrono::seconds>(wallNow.time_since_epoch()) +
+			std::chrono::seconds(1);
+	mStartTime = (time32_t)sinceEpoch.count();
+	mStartPoint = steadyNow + std::chrono::duration_cast<Clock::duration>(
+							std::chrono::system_clock::time_point(sinceEpoch) - wallNow);
+	mLatency = SLatency();
+	mProducerDone = false;
+	mSinkFailed = false;
+
+	std::thread	drainThread(&SubharmonicTransmitter::Drain, this);
+	uint64_t	samples;
+	bool		streamed = mSynthesizer.Stream(mStartTime, inSeconds, inPhaseModulation, samples);
+	mProducerDone = true;
+	drainThread.join();
+	return(streamed && !mSinkFailed);
+}
+
+/********************************** RingSink **********************************/
+/*
+*	The synthesizer's sink.  Waits while the ring is full, which is what
+*	keeps the synthesizer at most the ring length ahead of the sink.
+*/
+bool SubharmonicTransmitter::RingSink(
+	void*		inContext,
+	const void*	inData,
+	size_t		inBytes)
+{
+	SubharmonicTransmitter*	transmitter = (SubharmonicTransmitter*)inContext;
+	const uint8_t*	data = (const uint8_t*)inData;
+	while (inBytes &&
+		!transmitter->mSinkFailed)
+	{
+		size_t	written = transmitter->mRing.Write(data, inBytes);
+		data += written;
+		inBytes -= written;
+		if (inBytes)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+	return(!transmitter->mSinkFailed);
+}
+
+/*********************************** Drain ************************************/
+/*
+*	Runs on its own thread.  Passes the ring to the sink a hundredth of a
+*	second at a time, at each block's due time less the lead when paced.
+*/
+void SubharmonicTransmitter::Drain(void)
+{
+	uint32_t	sampleRate = mSynthesizer.SampleRate();
+	uint32_t	blockSamples = sampleRate / 100;
+	std::vector<int16_t>	block(blockSamples);
+	uint64_t	sample = 0;		// Of the start of the block
+	while (true)
+	{
+		/*
+		*	Wait for a whole block, or the last partial block.
+		*/
+		size_t	blockBytes = blockSamples * sizeof(int16_t);
+		bool	late = false;
+		while (mRing.Available() < blockBytes &&
+			!mProducerDone)
+		{
+			if (mPaced &&
+				Clock::now() >= (mStartPoint +
+								std::chrono::microseconds((sample * 1000000) / sampleRate) -
+								std::chrono::microseconds(mLead)))
+			{
+				late = true;
+			}
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+		size_t	bytes = mRing.Read(block.data(), blockBytes);
+		if (bytes == 0)
+		{
+			break;
+		}
+		mLatency.underruns += late;
+		Clock::time_point	due = mStartPoint +
+			std::chrono::microseconds((sample * 1000000) / sampleRate);
+		if (mPaced)
+		{
+			std::this_thread::sleep_until(due - std::chrono::microseconds(mLead));
+		}
+		if (mPaced &&
+			(sample % sampleRate) == 0)
+		{
+			int64_t	latency = std::chrono::duration_cast<std::chrono::microseconds>(
+								Clock::now() - due).count();
+			if (mLatency.edges == 0 ||
+				latency < mLatency.minimum)
+			{
+				mLatency.minimum = (int32_t)latency;
+			}
+			if (mLatency.edges == 0 ||
+				latency > mLatency.maximum)
+			{
+				mLatency.maximum = (int32_t)latency;
+			}
+			mLatency.total += latency;
+			mLatency.edges++;
+		}
+		if (!mSink(mSinkContext, block.data(), bytes))
+		{
+			mSinkFailed = true;
+			break;
+		}
+		sample += bytes / sizeof(int16_t);
+	}
+}
+#endif
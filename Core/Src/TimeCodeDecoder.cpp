@@ -0,0 +1,271 @@
+/*
+*	TimeCodeDecoder.cpp, Copyright Jonathan Mackey 2026
+*
+*	A reference receiver for the stations described by TimeCodeStation.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "TimeCodeDecoder.h"
+#if defined __linux__ || defined __MACH__
+#include "TimeCodeEncoder.h"
+#include "CivilCalendar.h"
+#include <math.h>
+
+static const uint64_t	kFrameMask = (1ULL << 60) - 1;
+
+/********************************* FieldBits **********************************/
+/*
+*	Returns the bits of inField in inPlane as a number, the inverse of the
+*	positioning done by TimeCodeEncoder::Rebuild.
+*/
+static uint32_t FieldBits(
+	uint64_t				inPlane,
+	const STimeCodeField&	inField)
+{
+	uint32_t	bits = 0;
+	if (inField.format & eTCF_LSBFirst)
+	{
+		bits = (uint32_t)(inPlane >> inField.firstSecond) & ((1UL << inField.width) - 1);
+	} else
+	{
+		for (uint8_t bit = 0; bit < inField.width; bit++)
+		{
+			bits = (bits << 1) | (uint32_t)((inPlane >> (inField.firstSecond + bit)) & 1);
+		}
+	}
+	return(bits);
+}
+
+/****************************** TimeCodeDecoder *******************************/
+TimeCodeDecoder::TimeCodeDecoder(
+	const STimeCodeStation&	inStation,
+	uint32_t				inSampleRate)
+	: mStation(inStation), mTenthSamples(inSampleRate / 10), mSampleCount(0),
+	  mSum(0), mTenth(0), mFull(0), mReduced(0), mSymbols{0, 0}, mMarks(0),
+	  mDataA(0), mDataB(0), mSeconds(0)
+{
+	mRule.Parse(inStation.timeZone);
+	for (uint8_t i = 0; i < inStation.fieldCount; i++)
+	{
+		const STimeCodeField&	field = inStation.fields[i];
+		uint64_t	bits = (((1ULL << field.width) - 1) << field.firstSecond);
+		if (field.format & eTCF_PlaneB)
+		{
+			mDataB |= bits;
+		} else
+		{
+			mDataA |= bits;
+		}
+	}
+	for (uint8_t i = 0; i < inStation.parityCount; i++)
+	{
+		const STimeCodeParity&	parity = inStation.parities[i];
+		if (parity.flags & eTCF_PlaneB)
+		{
+			mDataB |= 1ULL << parity.second;
+		} else
+		{
+			mDataA |= 1ULL << parity.second;
+		}
+	}
+}
+
+/********************************** Process ***********************************/
+bool TimeCodeDecoder::Process(
+	const float*	inSamples,
+	uint32_t		inCount,
+	time32_t&		outMinute)
+{
+	bool	decoded = false;
+	for (uint32_t i = 0; i < inCount; i++)
+	{
+		float	sampleI = inSamples[i * 2];
+		float	sampleQ = inSamples[(i * 2) + 1];
+		mSum += sqrtf((sampleI * sampleI) + (sampleQ * sampleQ));
+		if (++mSampleCount == mTenthSamples)
+		{
+			mTenths[mTenth] = mSum / mTenthSamples;
+			mSum = 0;
+			mSampleCount = 0;
+			if (++mTenth == 10)
+			{
+				mTenth = 0;
+				EndSecond();
+				decoded = decoded || Decode(outMinute);
+			}
+		}
+	}
+	return(decoded);
+}
+
+/********************************* EndSecond **********************************/
+/*
+*	Slices the second's tenths and shifts the nearest symbol into the last
+*	60 symbols.
+*/
+void TimeCodeDecoder::EndSecond(void)
+{
+	float	maxLevel = mTenths[0];
+	float	minLevel = mTenths[0];
+	for (uint32_t i = 1; i < 10; i++)
+	{
+		maxLevel = mTenths[i] > maxLevel ? mTenths[i] : maxLevel;
+		minLevel = mTenths[i] < minLevel ? mTenths[i] : minLevel;
+	}
+	if (mSeconds == 0)
+	{
+		mFull = maxLevel;
+		mReduced = minLevel;
+	} else
+	{
+		mFull += (maxLevel - mFull) * 0.125f;
+		mReduced += (minLevel - mReduced) * 0.125f;
+	}
+	float		threshold = (mFull + mReduced) * 0.5f;
+	uint32_t	pattern = 0;
+	for (uint32_t i = 0; i < 10; i++)
+	{
+		pattern |= (uint32_t)(mTenths[i] < threshold) << i;
+	}
+	uint32_t	symbol = 0;
+	int			distance = 11;
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		int	symbolDistance = __builtin_popcount(pattern ^ mStation.patterns[i]);
+		if (symbolDistance < distance)
+		{
+			distance = symbolDistance;
+			symbol = i;
+		}
+	}
+	uint64_t	mark = mStation.markSeconds &&
+					__builtin_popcount(pattern ^ mStation.markPattern) < distance;
+	if (mark)
+	{
+		symbol = 0;
+	}
+	mSymbols.a = (mSymbols.a >> 1) | ((uint64_t)(symbol & 1) << 59);
+	mSymbols.b = (mSymbols.b >> 1) | ((uint64_t)(symbol >> 1) << 59);
+	mMarks = (mMarks >> 1) | (mark << 59);
+	if (mSeconds < 60)
+	{
+		mSeconds++;
+	}
+}
+
+/*********************************** Decode ***********************************/
+/*
+*	Tries the last 60 symbols as a frame.
+*/
+bool TimeCodeDecoder::Decode(
+	time32_t&	outMinute)
+{
+	bool	valid = mSeconds == 60 &&
+					(mMarks & kFrameMask) == mStation.markSeconds &&
+					(mSymbols.a & ~mDataA & kFrameMask) == mStation.constantA &&
+					(mSymbols.b & ~mDataB & kFrameMask) == mStation.constantB;
+	for (uint8_t i = 0; valid && i < mStation.parityCount; i++)
+	{
+		const STimeCodeParity&	parity = mStation.parities[i];
+		uint64_t	plane = (parity.flags & eTCF_PlaneB) ? mSymbols.b : mSymbols.a;
+		valid = ((plane >> parity.second) & 1) ==
+				((uint64_t)__builtin_parityll(mSymbols.a & parity.coverage) ^
+					(parity.flags & TimeCodeStation::eOddParity));
+	}
+	/*
+	*	Each field's value must format back to the same bits, which rejects
+	*	BCD digits over 9 and broken unary runs.
+	*/
+	uint16_t	values[eTCS_SourceCount] = {0};
+	uint32_t	present = 0;
+	for (uint8_t i = 0; valid && i < mStation.fieldCount; i++)
+	{
+		const STimeCodeField&	field = mStation.fields[i];
+		uint32_t	bits = FieldBits((field.format & eTCF_PlaneB) ?
+										mSymbols.b : mSymbols.a, field);
+		uint32_t	value = bits;
+		switch (field.format & eTCF_FormatMask)
+		{
+			case eTCF_BCD:
+				value = 0;
+				for (int32_t shift = 28; shift >= 0; shift -= 4)
+				{
+					value = (value * 10) + ((bits >> shift) & 0xF);
+				}
+				break;
+			case eTCF_Tens:
+				value = bits * 10;
+				break;
+			case eTCF_Hundreds:
+				value = bits * 100;
+				break;
+			case eTCF_Unary:
+				value = (uint32_t)__builtin_popcount(bits);
+				break;
+		}
+		valid = TimeCodeEncoder::FormatValue(value, field.format) == bits;
+		values[field.source] += value;
+		present |= 1UL << field.source;
+	}
+	const uint32_t	kRequired = (1UL << eTCS_Minute) | (1UL << eTCS_Hour) | (1UL << eTCS_Year);
+	valid = valid &&
+			(present & kRequired) == kRequired &&
+			values[eTCS_Minute] < 60 &&
+			values[eTCS_Hour] < 24;
+	if (valid)
+	{
+		uint16_t	year = 2000 + values[eTCS_Year];
+		uint32_t	days;
+		if (present & (1UL << eTCS_DayOfYear))
+		{
+			valid = values[eTCS_DayOfYear] >= 1 &&
+					values[eTCS_DayOfYear] <= (365 + CivilCalendar::IsLeapYear(year));
+			days = CivilCalendar::DaysFromCivil(year, 1, 1) + values[eTCS_DayOfYear] - 1;
+		} else
+		{
+			uint8_t	month = (uint8_t)values[eTCS_Month];
+			uint8_t	day = (uint8_t)values[eTCS_Day];
+			valid = month >= 1 && month <= 12 &&
+					day >= 1 && day <= CivilCalendar::DaysInMonth(month, year);
+			days = CivilCalendar::DaysFromCivil(year, month, day);
+		}
+		time32_t	local = ((days - CivilCalendar::kUnixEpochDays) * 86400) +
+							(values[eTCS_Hour] * 3600) + (values[eTCS_Minute] * 60);
+		time32_t	utc;
+		/*
+		*	When the frame says whether DST is in effect it's used, otherwise
+		*	the rule decides.
+		*/
+		if (mRule.HasDST() &&
+			(present & (1UL << eTCS_DST)))
+		{
+			if (present & (1UL << eTCS_StandardTime))
+			{
+				valid = valid && values[eTCS_DST] != values[eTCS_StandardTime];
+			}
+			utc = local - (values[eTCS_DST] ? mRule.DSTOffset() : mRule.StandardOffset());
+		} else
+		{
+			utc = mRule.LocalToUTC(local);
+		}
+		outMinute = utc - (mStation.minuteOffset * 60);
+	}
+	return(valid);
+}
+#endif
@@ -0,0 +1,173 @@
+/*
+*	TimeCodeEncoder.cpp, Copyright Jonathan Mackey 2026
+*
+*	Builds the frames of any station described by a TimeCodeStation
+*	descriptor.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "TimeCodeEncoder.h"
+#include "UnixTimeWWVB.h"
+#include "CivilCalendar.h"
+#include "LeapSeconds.h"
+#include "DUT1Schedule.h"
+
+/****************************** TimeCodeEncoder *******************************/
+TimeCodeEncoder::TimeCodeEncoder(
+	const STimeCodeStation&	inStation)
+	: mStation(inStation), mTime(0)
+{
+	mRule.Parse(inStation.timeZone);
+	mFrame.a = mFrame.b = 0;
+}
+
+/*********************************** Encode ***********************************/
+const STimeCodeFrame& TimeCodeEncoder::Encode(
+	time32_t	inTime)
+{
+	inTime -= (inTime % 60);
+	if (inTime != mTime)
+	{
+		Rebuild(inTime);
+	}
+	return(mFrame);
+}
+
+/********************************** Rebuild ***********************************/
+void TimeCodeEncoder::Rebuild(
+	time32_t	inTime)
+{
+	mTime = inTime - (inTime % 60);
+	uint16_t	values[eTCS_SourceCount];
+	LoadSources(mTime + (mStation.minuteOffset * 60), values);
+	uint64_t	planes[2] = {mStation.constantA, mStation.constantB};
+	for (uint8_t i = 0; i < mStation.fieldCount; i++)
+	{
+		const STimeCodeField&	field = mStation.fields[i];
+		uint32_t	bits = FormatValue(values[field.source], field.format);
+		uint64_t&	plane = planes[(field.format & eTCF_PlaneB) != 0];
+		if (field.format & eTCF_LSBFirst)
+		{
+			plane |= (uint64_t)(bits & ((1UL << field.width) - 1)) << field.firstSecond;
+		} else
+		{
+			for (uint8_t bit = 0; bit < field.width; bit++)
+			{
+				plane |= (uint64_t)((bits >> (field.width - 1 - bit)) & 1) <<
+							(field.firstSecond + bit);
+			}
+		}
+	}
+	/*
+	*	Parity bits are computed after all of the fields are in place.
+	*/
+	for (uint8_t i = 0; i < mStation.parityCount; i++)
+	{
+		const STimeCodeParity&	parity = mStation.parities[i];
+		uint32_t	bit = (uint32_t)__builtin_parityll(planes[0] & parity.coverage) ^
+							(parity.flags & TimeCodeStation::eOddParity);
+		planes[(parity.flags & eTCF_PlaneB) != 0] |= (uint64_t)bit << parity.second;
+	}
+	mFrame.a = planes[0];
+	mFrame.b = planes[1];
+}
+
+/******************************** LoadSources *********************************/
+/*
+*	inTime is the UTC minute the frame describes.
+*/
+void TimeCodeEncoder::LoadSources(
+	time32_t	inTime,
+	uint16_t*	outValues)
+{
+	bool		dst = mRule.IsDST(inTime);
+	time32_t	local = inTime + (dst ? mRule.DSTOffset() : mRule.StandardOffset());
+	SUnixTimeComponents	components;
+	UnixTimeConverter<time32_t>::ToComponents(local, components);
+	uint16_t	dayOfYear = CivilCalendar::DayOfYear(components.year,
+													components.month,
+													components.day);
+	uint8_t		dayOfWeek = UnixTimeConverter<time32_t>::DayOfWeek(local);
+	outValues[eTCS_Minute] = components.minute;
+	outValues[eTCS_Hour] = components.hour;
+	outValues[eTCS_Day] = components.day;
+	outValues[eTCS_Month] = components.month;
+	outValues[eTCS_Year] = components.year % 100;
+	outValues[eTCS_DayOfYear] = dayOfYear;
+	outValues[eTCS_DayOfWeek] = dayOfWeek;
+	outValues[eTCS_DayOfWeekISO] = dayOfWeek ? dayOfWeek : 7;
+	outValues[eTCS_DST] = dst;
+	outValues[eTCS_StandardTime] = !dst;
+	outValues[eTCS_DSTChange] = mRule.HasDST() && mRule.IsDST(inTime + 3600) != dst;
+	// Only meaningful when the station's time zone is UTC
+	outValues[eTCS_WWVBDST] = UnixTimeWWVB::DSTStatus(components.year, dayOfYear);
+	outValues[eTCS_LeapYear] = CivilCalendar::IsLeapYear(components.year);
+
+	int8_t		leapSecond = LeapSeconds::LeapSecondAtEOM(inTime);
+	time32_t	leapSecondTime;
+	int8_t		delta;
+	outValues[eTCS_LeapSecondMonth] = leapSecond != 0;
+	outValues[eTCS_LeapSecondHour] =
+		LeapSeconds::NextLeapSecond(inTime, leapSecondTime, delta) &&
+		(leapSecondTime - inTime) <= 3600;
+	outValues[eTCS_JJYLeapSecond] = leapSecond ? (leapSecond > 0 ? 3 : 2) : 0;
+
+	int8_t		dut1 = DUT1Schedule::DUT1(inTime);
+	outValues[eTCS_WWVBDUT1Sign] = dut1 < 0 ? UnixTimeWWVB::eDUT_Negative :
+											UnixTimeWWVB::eDUT_Positive;
+	outValues[eTCS_DUT1] = dut1 < 0 ? -dut1 : dut1;
+	outValues[eTCS_DUT1Positive] = dut1 > 0 ? dut1 : 0;
+	outValues[eTCS_DUT1Negative] = dut1 < 0 ? -dut1 : 0;
+}
+
+/******************************** FormatValue *********************************/
+uint32_t TimeCodeEncoder::FormatValue(
+	uint32_t	inValue,
+	uint8_t		inFormat)
+{
+	uint32_t	bits = inValue;
+	switch (inFormat & eTCF_FormatMask)
+	{
+		case eTCF_BCD:
+		{
+			uint32_t	shift = 0;
+			bits = 0;
+			do
+			{
+				bits |= (inValue % 10) << shift;
+				inValue /= 10;
+				shift += 4;
+			} while (inValue);
+			break;
+		}
+		case eTCF_Units:
+			bits = inValue % 10;
+			break;
+		case eTCF_Tens:
+			bits = (inValue / 10) % 10;
+			break;
+		case eTCF_Hundreds:
+			bits = (inValue / 100) % 10;
+			break;
+		case eTCF_Unary:
+			bits = inValue < 32 ? ((1UL << inValue) - 1) : 0xFFFFFFFF;
+			break;
+	}
+	return(bits);
+}
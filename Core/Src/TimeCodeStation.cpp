@@ -0,0 +1,62 @@
+/*
+*	TimeCodeStation.cpp, Copyright Jonathan Mackey 2026
+*
+*	Compile time frame descriptors for the WWVB, DCF77, MSF and JJY time
+*	code stations.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "TimeCodeStation.h"
+#include <string.h>
+
+constexpr STimeCodeField	TimeCodeStation::kWWVBFields[];
+constexpr STimeCodeStation	TimeCodeStation::kWWVB;
+constexpr STimeCodeField	TimeCodeStation::kDCF77Fields[];
+constexpr STimeCodeParity	TimeCodeStation::kDCF77Parities[];
+constexpr STimeCodeStation	TimeCodeStation::kDCF77;
+constexpr STimeCodeField	TimeCodeStation::kMSFFields[];
+constexpr STimeCodeParity	TimeCodeStation::kMSFParities[];
+constexpr STimeCodeStation	TimeCodeStation::kMSF;
+constexpr STimeCodeField	TimeCodeStation::kJJYFields[];
+constexpr STimeCodeParity	TimeCodeStation::kJJYParities[];
+constexpr STimeCodeStation	TimeCodeStation::kJJY;
+
+const STimeCodeStation* const	TimeCodeStation::kStations[] =
+{
+	&kWWVB,
+	&kDCF77,
+	&kMSF,
+	&kJJY
+};
+
+/************************************ Find ************************************/
+const STimeCodeStation* TimeCodeStation::Find(
+	const char*	inName)
+{
+	const STimeCodeStation*	station = nullptr;
+	for (uint8_t i = 0; i < kStationCount; i++)
+	{
+		if (strcmp(kStations[i]->name, inName) == 0)
+		{
+			station = kStations[i];
+			break;
+		}
+	}
+	return(station);
+}
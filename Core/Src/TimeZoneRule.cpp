@@ -0,0 +1,408 @@
+/*
+*	TimeZoneRule.cpp, Copyright Jonathan Mackey 2026
+*
+*	Local time from a POSIX TZ string.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "TimeZoneRule.h"
+#include "CivilCalendar.h"
+#include <string.h>
+#ifdef __linux__
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+/******************************** TimeZoneRule ********************************/
+TimeZoneRule::TimeZoneRule(void)
+{
+	Parse("UTC0");
+}
+
+/*********************************** Parse ************************************/
+bool TimeZoneRule::Parse(
+	const char*	inTZString)
+{
+	const char*	str = inTZString;
+	int32_t		offset;
+	mHasDST = false;
+	mDSTName[0] = 0;
+	// A leading colon means implementation defined, which isn't supported.
+	bool	success = str && *str != ':';
+	if (success)
+	{
+		str = ParseName(str, mStdName);
+		str = ParseTime(str, 24, offset);
+		success = str != nullptr;
+	}
+	if (success)
+	{
+		// POSIX offsets are positive west of Greenwich.
+		mStdOffset = -offset;
+		mDSTOffset = mStdOffset + 3600;
+		if (*str)
+		{
+			str = ParseName(str, mDSTName);
+			if (str && *str && *str != ',')
+			{
+				str = ParseTime(str, 24, offset);
+				mDSTOffset = -offset;
+			}
+			if (str && *str == 0)
+			{
+				// No rules, use the US rules, M3.2.0,M11.1.0
+				str = ",M3.2.0,M11.1.0";
+			}
+			if (str && *str == ',')
+			{
+				str = ParseRule(str + 1, mStart);
+				if (str && *str == ',')
+				{
+					str = ParseRule(str + 1, mEnd);
+				} else
+				{
+					str = nullptr;
+				}
+			} else
+			{
+				str = nullptr;
+			}
+			// Anything after the end rule isn't valid.
+			success = str != nullptr && *str == 0;
+			mHasDST = success;
+		}
+	}
+	if (!success)
+	{
+		strcpy(mStdName, "UTC");
+		mDSTName[0] = 0;
+		mStdOffset = mDSTOffset = 0;
+	}
+	if (mHasDST)
+	{
+		// Force the transitions to be computed on the first conversion
+		mYearStart = mYearEnd = 0;
+	} else
+	{
+		// Any time is in the "cached year" and never in DST
+		mYearStart = INT64_MIN;
+		mYearEnd = INT64_MAX;
+		mRangeStart = mRangeEnd = 0;
+		mRangeIsDST = true;
+	}
+	return(success);
+}
+
+#ifdef __linux__
+/**************************** ParseSystemTimeZone *****************************/
+bool TimeZoneRule::ParseSystemTimeZone(void)
+{
+	bool	success = Parse(getenv("TZ"));
+	if (!success)
+	{
+		/*
+		*	A version 2 or later TZif file ends with a newline enclosed POSIX
+		*	TZ string describing times after the last transition in the file.
+		*/
+		FILE*	file = fopen("/etc/localtime", "rb");
+		if (file)
+		{
+			char	footer[64];
+			size_t	length = 0;
+			if (fseek(file, -(long)(sizeof(footer) - 1), SEEK_END) == 0 ||
+				fseek(file, 0, SEEK_SET) == 0)
+			{
+				length = fread(footer, 1, sizeof(footer) - 1, file);
+			}
+			fclose(file);
+			footer[length] = 0;
+			if (length > 1 && footer[length - 1] == '\n')
+			{
+				// The data preceding the footer is binary, so strrchr can't be used.
+				footer[--length] = 0;
+				while (length && footer[length - 1] != '\n')
+				{
+					length--;
+				}
+				if (length)
+				{
+					success = Parse(&footer[length]);
+				}
+			}
+		}
+	}
+	return(success);
+}
+#endif
+
+/********************************* LocalToUTC *********************************/
+time32_t TimeZoneRule::LocalToUTC(
+	time32_t	inLocal)
+{
+	/*
+	*	Viewed as wall clock times, both transitions occur at the DST wall
+	*	clock time, i.e. UTC + mDSTOffset.  The year is first taken from the
+	*	standard time guess.  If the result lands in a different year, such
+	*	as with a transition shortly after the new year, the test is redone
+	*	with that year's transitions.
+	*/
+	time64_t	local = inLocal;
+	time64_t	utc = local - mStdOffset;
+	for (uint8_t pass = 0; pass < 2; pass++)
+	{
+		LoadYearOf(utc);
+		bool	isDST = (local >= (mRangeStart + mDSTOffset) &&
+							local < (mRangeEnd + mDSTOffset)) == mRangeIsDST;
+		utc = local - (isDST ? mDSTOffset : mStdOffset);
+		if (utc >= mYearStart && utc < mYearEnd)
+		{
+			break;
+		}
+	}
+	return((time32_t)utc);
+}
+
+/******************************** Transitions *********************************/
+bool TimeZoneRule::Transitions(
+	uint16_t	inYear,
+	time64_t&	outDSTStart,
+	time64_t&	outDSTEnd)
+{
+	if (mHasDST)
+	{
+		LoadYear(inYear);
+		outDSTStart = mRangeIsDST ? mRangeStart : mRangeEnd;
+		outDSTEnd = mRangeIsDST ? mRangeEnd : mRangeStart;
+	}
+	return(mHasDST);
+}
+
+/********************************** LoadYear **********************************/
+void TimeZoneRule::LoadYear(
+	uint16_t	inYear)
+{
+	mYearStart = ((time64_t)CivilCalendar::DaysFromCivil(inYear, 1, 1) -
+								CivilCalendar::kUnixEpochDays) * 86400;
+	mYearEnd = ((time64_t)CivilCalendar::DaysFromCivil(inYear + 1, 1, 1) -
+								CivilCalendar::kUnixEpochDays) * 86400;
+	// The start rule time is standard time, the end rule time is DST.
+	time64_t	dstStart = (RuleDays(mStart, inYear) * 86400) +
+							mStart.time - mStdOffset;
+	time64_t	dstEnd = (RuleDays(mEnd, inYear) * 86400) +
+							mEnd.time - mDSTOffset;
+	mRangeIsDST = dstStart <= dstEnd;
+	mRangeStart = mRangeIsDST ? dstStart : dstEnd;
+	mRangeEnd = mRangeIsDST ? dstEnd : dstStart;
+}
+
+/********************************** RuleDays **********************************/
+/*
+*	Returns the day of inRule in inYear as days since 1-JAN-1970.
+*/
+time64_t TimeZoneRule::RuleDays(
+	const SRule&	inRule,
+	uint16_t		inYear)
+{
+	time64_t	days;
+	if (inRule.type == eMonthWeekDay)
+	{
+		days = (time64_t)CivilCalendar::DaysFromCivil(inYear, inRule.month, 1) -
+					CivilCalendar::kUnixEpochDays;
+		// 1-JAN-1970 was a Thursday, the + 70000 keeps the modulo positive.
+		uint8_t	firstDayOfWeek = (days + 70004) % 7;
+		uint8_t	day = 1 + ((inRule.dayOfWeek + 7 - firstDayOfWeek) % 7) +
+							((inRule.week - 1) * 7);
+		if (day > CivilCalendar::DaysInMonth(inRule.month, inYear))
+		{
+			day -= 7;
+		}
+		days += day - 1;
+	} else
+	{
+		days = ((time64_t)CivilCalendar::DaysFromCivil(inYear, 1, 1) -
+					CivilCalendar::kUnixEpochDays) + inRule.day;
+		if (inRule.type == eJulian1)
+		{
+			// Jn is 1 based and never counts Feb 29
+			days -= (inRule.day >= 60 && CivilCalendar::IsLeapYear(inYear)) ? 0 : 1;
+		}
+	}
+	return(days);
+}
+
+/********************************* ParseName **********************************/
+/*
+*	Returns a pointer to the character following the name or nullptr if the
+*	name isn't valid.  A nullptr inStr is passed through.
+*/
+const char* TimeZoneRule::ParseName(
+	const char*	inStr,
+	char*		outName)
+{
+	const char*	str = inStr;
+	if (str)
+	{
+		uint8_t	length = 0;
+		if (*str == '<')
+		{
+			for (str++; *str && *str != '>'; str++)
+			{
+				if (length < kMaxNameLen)
+				{
+					outName[length++] = *str;
+				}
+			}
+			str = *str == '>' ? (str + 1) : nullptr;
+		} else
+		{
+			for (; ((*str | 0x20) >= 'a' && (*str | 0x20) <= 'z'); str++)
+			{
+				if (length < kMaxNameLen)
+				{
+					outName[length++] = *str;
+				}
+			}
+			if (length < 3)
+			{
+				str = nullptr;
+			}
+		}
+		outName[length] = 0;
+	}
+	return(str);
+}
+
+/********************************* ParseTime **********************************/
+/*
+*	[+-]hh[:mm[:ss]]
+*	Returns a pointer to the character following the time or nullptr if the
+*	time isn't valid.  A nullptr inStr is passed through.
+*/
+const char* TimeZoneRule::ParseTime(
+	const char*	inStr,
+	uint8_t		inMaxHours,
+	int32_t&	outSeconds)
+{
+	const char*	str = inStr;
+	if (str)
+	{
+		bool	negative = *str == '-';
+		if (negative || *str == '+')
+		{
+			str++;
+		}
+		int32_t	seconds = 0;
+		int32_t	multiplier = 3600;
+		uint8_t	maxValue = inMaxHours;
+		for (uint8_t field = 0; str && field < 3; field++)
+		{
+			uint16_t	value = 0;
+			uint8_t		digits = 0;
+			for (; (uint8_t)(*str - '0') < 10 && digits < 3; str++, digits++)
+			{
+				value = (value * 10) + (*str - '0');
+			}
+			if (digits == 0 || value > maxValue)
+			{
+				str = nullptr;
+				break;
+			}
+			seconds += value * multiplier;
+			if (*str != ':')
+			{
+				break;
+			}
+			str++;
+			multiplier /= 60;
+			maxValue = 59;
+		}
+		outSeconds = negative ? -seconds : seconds;
+	}
+	return(str);
+}
+
+/********************************* ParseRule **********************************/
+/*
+*	Jn[/time], n[/time] or Mm.w.d[/time]
+*	Returns a pointer to the character following the rule or nullptr if the
+*	rule isn't valid.
+*/
+const char* TimeZoneRule::ParseRule(
+	const char*	inStr,
+	SRule&		outRule)
+{
+	const char*	str = inStr;
+	uint16_t	values[3] = {0};
+	outRule.type = eJulian0;
+	if (*str == 'J')
+	{
+		outRule.type = eJulian1;
+		str++;
+	} else if (*str == 'M')
+	{
+		outRule.type = eMonthWeekDay;
+		str++;
+	}
+	// Mm.w.d has 3 dot separated values, the others have 1
+	uint8_t	valueCount = outRule.type == eMonthWeekDay ? 3 : 1;
+	for (uint8_t i = 0; str && i < valueCount; i++)
+	{
+		if (i && *(str++) != '.')
+		{
+			str = nullptr;
+			break;
+		}
+		uint8_t	digits = 0;
+		for (; (uint8_t)(*str - '0') < 10 && digits < 3; str++, digits++)
+		{
+			values[i] = (values[i] * 10) + (*str - '0');
+		}
+		if (digits == 0)
+		{
+			str = nullptr;
+		}
+	}
+	if (str)
+	{
+		bool	valid;
+		if (outRule.type == eMonthWeekDay)
+		{
+			outRule.month = values[0];
+			outRule.week = values[1];
+			outRule.dayOfWeek = values[2];
+			valid = outRule.month >= 1 && outRule.month <= 12 &&
+					outRule.week >= 1 && outRule.week <= 5 &&
+					outRule.dayOfWeek <= 6;
+		} else
+		{
+			outRule.day = values[0];
+			valid = outRule.type == eJulian1 ?
+					(outRule.day >= 1 && outRule.day <= 365) : outRule.day <= 365;
+		}
+		outRule.time = 2 * 3600;	// The default is 02:00:00
+		if (valid && *str == '/')
+		{
+			str = ParseTime(str + 1, 167, outRule.time);
+		} else if (!valid)
+		{
+			str = nullptr;
+		}
+	}
+	return(str);
+}
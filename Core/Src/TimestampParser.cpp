@@ -0,0 +1,437 @@
+/*
+*	TimestampParser.cpp, Copyright Jonathan Mackey 2026
+*
+*	Parses date/time strings in any of several formats to Unix time.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "TimestampParser.h"
+#include "CivilCalendar.h"
+#include <string.h>
+
+/*
+*	An 8 character pattern describing one chunk of a string.  'd' is a digit,
+*	'?' is any character (checked separately), anything else must match
+*	exactly.  The masks are computed at compile time.
+*/
+struct SChunkPattern
+{
+	uint64_t	digitMask;
+	uint64_t	literalMask;
+	uint64_t	literals;
+};
+
+static constexpr SChunkPattern ChunkPattern(
+	const char*	inPattern)
+{
+	SChunkPattern	pattern = {0, 0, 0};
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		uint64_t	byteMask = 0xFFULL << (i*8);
+		if (inPattern[i] == 'd')
+		{
+			pattern.digitMask |= byteMask;
+		} else if (inPattern[i] != '?')
+		{
+			pattern.literalMask |= byteMask;
+			pattern.literals |= (uint64_t)(uint8_t)inPattern[i] << (i*8);
+		}
+	}
+	return(pattern);
+}
+
+static constexpr SChunkPattern	kYearMonth = ChunkPattern("dddd-dd-");	// ISO [0,8)
+static constexpr SChunkPattern	kDayHour = ChunkPattern("dd?dd:dd");	// ISO [8,16)
+static constexpr SChunkPattern	kYYMMDD = ChunkPattern("dd/dd/dd");		// CCLK [0,8)
+static constexpr SChunkPattern	kDayYear = ChunkPattern("?dd?dddd");	// Month [3,11)
+static constexpr SChunkPattern	kTime = ChunkPattern("dd:dd:dd");
+
+static constexpr uint32_t MonthName(
+	const char*	inName)
+{
+	return((uint8_t)inName[0] | ((uint8_t)inName[1] << 8) |
+				((uint32_t)(uint8_t)inName[2] << 16));
+}
+
+const uint32_t	TimestampParser::kMonthNames[] =
+{
+	MonthName("jan"), MonthName("feb"), MonthName("mar"), MonthName("apr"),
+	MonthName("may"), MonthName("jun"), MonthName("jul"), MonthName("aug"),
+	MonthName("sep"), MonthName("oct"), MonthName("nov"), MonthName("dec")
+};
+
+/*********************************** Load8 ************************************/
+static inline uint64_t Load8(
+	const char*	inString)
+{
+	uint64_t	chunk;
+	memcpy(&chunk, inString, 8);	// Compiles to a single (unaligned) load
+	return(chunk);
+}
+
+/********************************* DigitPairs *********************************/
+/*
+*	Validates inChunk against inPattern and converts it so that byte n of
+*	outPairs is the 2 digit value of bytes n and n+1, i.e. for a digit pair
+*	starting at n, PairAt(outPairs, n) is its value.  Returns false if any
+*	digit isn't a digit or any literal doesn't match.
+*/
+static inline bool DigitPairs(
+	uint64_t				inChunk,
+	const SChunkPattern&	inPattern,
+	uint64_t&				outPairs)
+{
+	const uint64_t	kZeros = 0x3030303030303030ULL;
+	/*
+	*	Non-digit positions are replaced with '0' so only the digit positions
+	*	affect the range check.  A byte is a digit when neither adding 0x46
+	*	(overflows into bit 7 for > '9') nor subtracting 0x30 (borrows into
+	*	bit 7 for < '0') sets its high bit.
+	*/
+	uint64_t	digits = (inChunk & inPattern.digitMask) |
+							(kZeros & ~inPattern.digitMask);
+	bool	valid = (inChunk & inPattern.literalMask) == inPattern.literals &&
+				(((digits + 0x4646464646464646ULL) | (digits - kZeros)) &
+					0x8080808080808080ULL) == 0;
+	digits -= kZeros;
+	outPairs = (digits * 10) + (digits >> 8);
+	return(valid);
+}
+
+static inline uint8_t PairAt(
+	uint64_t	inPairs,
+	uint32_t	inIndex)
+{
+	return((uint8_t)(inPairs >> (inIndex * 8)));
+}
+
+static inline bool TwoDigits(
+	const char*	inString,
+	uint8_t&	outValue)
+{
+	uint8_t	tens = (uint8_t)(inString[0] - '0');
+	uint8_t	ones = (uint8_t)(inString[1] - '0');
+	outValue = (tens * 10) + ones;
+	return(tens < 10 && ones < 10);
+}
+
+/*********************************** Parse ************************************/
+bool TimestampParser::Parse(
+	const char*	inString,
+	size_t		inLength,
+	STimestamp&	outTimestamp)
+{
+	outTimestamp.format = eFormat_Unknown;
+	outTimestamp.offset = 0;
+	outTimestamp.timeIsUTC = false;
+	bool	success = false;
+	if (inLength >= 17)
+	{
+		if (inString[2] == '/')
+		{
+			success = ParseCCLK(inString, inLength, outTimestamp);
+		} else if (inString[4] == '-')
+		{
+			success = ParseISO8601(inString, inLength, outTimestamp);
+		} else if (inString[3] == '-' && (inString[0] | 0x20) >= 'a')
+		{
+			success = ParseMonth(inString, inLength, outTimestamp);
+		}
+	}
+	return(success);
+}
+
+/********************************* ParseCCLK **********************************/
+/*
+*	YY/MM/DD,hh:mm:ss[+-uu] or YY/MM/DD,hh:mm:ss","+-uu",DST
+*	Only 20YY is supported.  YY >= 80 is returned as invalid because this only
+*	happens after the modem's battery has been removed and there has been no
+*	network time update (the modem reports 80/01/06.)
+*/
+bool TimestampParser::ParseCCLK(
+	const char*	inString,
+	size_t		inLength,
+	STimestamp&	outTimestamp)
+{
+	uint64_t	date;
+	uint32_t	secondOfDay;
+	bool	success = DigitPairs(Load8(inString), kYYMMDD, date) &&
+						inString[8] == ',' &&
+						ParseTime(&inString[9], secondOfDay) &&
+						PairAt(date, 0) < 80 &&
+						ToTime(PairAt(date, 0) + 2000, PairAt(date, 3),
+								PairAt(date, 6), secondOfDay, outTimestamp.time);
+	if (success)
+	{
+		outTimestamp.format = eFormat_CCLK;
+		size_t	index = 17;
+		if (index < inLength && inString[index] == '\"')
+		{
+			outTimestamp.format = eFormat_PSUTTZ;
+			outTimestamp.timeIsUTC = true;
+			// Skip the quotes and commas between the time and the timezone
+			for (index++; index < inLength &&
+					(inString[index] == '\"' || inString[index] == ','); index++){}
+		}
+		uint8_t	quarterHours;
+		if ((index + 3) <= inLength &&
+			(inString[index] == '-' || inString[index] == '+') &&
+			TwoDigits(&inString[index + 1], quarterHours))
+		{
+			outTimestamp.offset = (int32_t)quarterHours * (15 * 60);
+			if (inString[index] == '-')
+			{
+				outTimestamp.offset = -outTimestamp.offset;
+			}
+		}
+	}
+	return(success);
+}
+
+/********************************* ParseMonth *********************************/
+/*
+*	Mmm-DD-YYYY hh:mm:ss
+*/
+bool TimestampParser::ParseMonth(
+	const char*	inString,
+	size_t		inLength,
+	STimestamp&	outTimestamp)
+{
+	uint16_t	year;
+	uint8_t		month, day;
+	uint32_t	secondOfDay;
+	bool	success = inLength >= 20 &&
+						ParseMonthDate(inString, year, month, day) &&
+						(inString[11] == ' ' || inString[11] == 'T') &&
+						ParseTime(&inString[12], secondOfDay) &&
+						ToTime(year, month, day, secondOfDay, outTimestamp.time);
+	if (success)
+	{
+		outTimestamp.format = eFormat_Month;
+	}
+	return(success);
+}
+
+/******************************* ParseMonthDate *******************************/
+/*
+*	Mmm-DD-YYYY, inDateStr must have at least 11 characters.  Spaces may be
+*	used in place of the dashes and the day may be space padded, so the
+*	compiler's __DATE__ (Mmm DD YYYY) is also accepted.
+*/
+bool TimestampParser::ParseMonthDate(
+	const char*	inDateStr,
+	uint16_t&	outYear,
+	uint8_t&	outMonth,
+	uint8_t&	outDay)
+{
+	uint64_t	dayYear = Load8(&inDateStr[3]);
+	// A space padded day becomes a leading zero (0x20 | 0x10 = '0')
+	if (inDateStr[4] == ' ')
+	{
+		dayYear |= 0x1000;
+	}
+	bool	success = (inDateStr[3] == '-' || inDateStr[3] == ' ') &&
+						(inDateStr[6] == '-' || inDateStr[6] == ' ') &&
+						DigitPairs(dayYear, kDayYear, dayYear);
+	outDay = PairAt(dayYear, 1);
+	outYear = ((uint16_t)PairAt(dayYear, 4) * 100) + PairAt(dayYear, 6);
+	// Setting bit 5 of each letter makes the compare case insensitive.
+	uint32_t	name = MonthName(inDateStr) | 0x202020;
+	outMonth = 0;
+	for (uint8_t i = 0; i < 12; i++)
+	{
+		if (kMonthNames[i] == name)
+		{
+			outMonth = i + 1;
+			break;
+		}
+	}
+	return(success && outMonth);
+}
+
+/******************************** ParseISO8601 ********************************/
+/*
+*	YYYY-MM-DDThh:mm:ss[.fff][Z|+-hh[[:]mm]]
+*/
+bool TimestampParser::ParseISO8601(
+	const char*	inString,
+	size_t		inLength,
+	STimestamp&	outTimestamp)
+{
+	uint64_t	yearMonth, dayHour;
+	uint32_t	secondOfDay;
+	bool	success = inLength >= 19 &&
+						DigitPairs(Load8(inString), kYearMonth, yearMonth) &&
+						DigitPairs(Load8(&inString[8]), kDayHour, dayHour) &&
+						(inString[10] == 'T' || inString[10] == ' ' ||
+							inString[10] == 't') &&
+						ParseTime(&inString[11], secondOfDay) &&
+						ToTime(((uint16_t)PairAt(yearMonth, 0) * 100) +
+									PairAt(yearMonth, 2),
+								PairAt(yearMonth, 5), PairAt(dayHour, 0),
+								secondOfDay, outTimestamp.time);
+	if (success)
+	{
+		outTimestamp.format = eFormat_ISO8601;
+		size_t	index = 19;
+		// Skip the fraction of a second, if any.
+		if (index < inLength && (inString[index] == '.' || inString[index] == ','))
+		{
+			for (index++; index < inLength &&
+					(uint8_t)(inString[index] - '0') < 10; index++){}
+		}
+		uint8_t	hours, minutes = 0;
+		if (index < inLength)
+		{
+			char	thisChar = inString[index];
+			if (thisChar == 'Z' || thisChar == 'z')
+			{
+				outTimestamp.timeIsUTC = true;
+			} else if ((index + 3) <= inLength &&
+				(thisChar == '+' || thisChar == '-') &&
+				TwoDigits(&inString[index + 1], hours) &&
+				hours < 24)
+			{
+				index += 3;
+				if (index < inLength && inString[index] == ':')
+				{
+					index++;
+				}
+				uint8_t	tzMinutes;
+				if ((index + 2) <= inLength &&
+					TwoDigits(&inString[index], tzMinutes) &&
+					tzMinutes < 60)
+				{
+					minutes = tzMinutes;
+				}
+				outTimestamp.offset = ((int32_t)hours * 3600) + (minutes * 60);
+				if (thisChar == '-')
+				{
+					outTimestamp.offset = -outTimestamp.offset;
+				}
+			}
+		}
+	}
+	return(success);
+}
+
+/********************************* ParseTime **********************************/
+/*
+*	hh:mm:ss, inTimeStr must have at least 8 characters.  A second of 60 is
+*	accepted for a leap second.
+*/
+bool TimestampParser::ParseTime(
+	const char*	inTimeStr,
+	uint32_t&	outSecondOfDay)
+{
+	uint64_t	time;
+	bool	success = DigitPairs(Load8(inTimeStr), kTime, time);
+	uint8_t	hour = PairAt(time, 0);
+	uint8_t	minute = PairAt(time, 3);
+	uint8_t	second = PairAt(time, 6);
+	outSecondOfDay = ((uint32_t)hour * 3600) + (minute * 60) + second;
+	return(success && hour < 24 && minute < 60 && second <= 60);
+}
+
+/*********************************** ToTime ***********************************/
+/*
+*	Validates the date and converts it to a time32_t.  Returns false if the
+*	date isn't valid or isn't representable (before 1970 or after 2106.)
+*/
+bool TimestampParser::ToTime(
+	uint16_t	inYear,
+	uint8_t		inMonth,
+	uint8_t		inDay,
+	uint32_t	inSecondOfDay,
+	time32_t&	outTime)
+{
+	bool	success = inYear >= 1970 && inMonth >= 1 && inMonth <= 12 &&
+						inDay >= 1 &&
+						inDay <= CivilCalendar::DaysInMonth(inMonth, inYear);
+	if (success)
+	{
+		uint64_t	time = ((uint64_t)(CivilCalendar::DaysFromCivil(inYear,
+										inMonth, inDay) -
+											CivilCalendar::kUnixEpochDays) *
+												86400) + inSecondOfDay;
+		success = time <= 0xFFFFFFFF;
+		outTime = (time32_t)time;
+	}
+	return(success);
+}
+
+/*************************** ParseMonthDateAndTime ****************************/
+time32_t TimestampParser::ParseMonthDateAndTime(
+	const char*	inDateStr,
+	const char*	inTimeStr)
+{
+	uint16_t	year;
+	uint8_t		month, day;
+	uint32_t	secondOfDay;
+	time32_t	time;
+	/*
+	*	memchr is used to verify the lengths so that nothing is read past the
+	*	terminator of a short string.
+	*/
+	if (memchr(inDateStr, 0, 11) ||
+		memchr(inTimeStr, 0, 8) ||
+		!ParseMonthDate(inDateStr, year, month, day) ||
+		!ParseTime(inTimeStr, secondOfDay) ||
+		!ToTime(year, month, day, secondOfDay, time))
+	{
+		time = 0;
+	}
+	return(time);
+}
+
+/********************************* ParseLines *********************************/
+size_t TimestampParser::ParseLines(
+	const char*	inBuffer,
+	size_t		inLength,
+	time32_t*	outTimes,
+	size_t		inMaxTimes,
+	bool		inLocal,
+	size_t*		outConsumed)
+{
+	const char*	linePtr = inBuffer;
+	const char*	endPtr = &inBuffer[inLength];
+	size_t		count = 0;
+	STimestamp	timestamp;
+	while (linePtr < endPtr && count < inMaxTimes)
+	{
+		const char*	eolPtr = (const char*)memchr(linePtr, '\n', endPtr - linePtr);
+		const char*	nextLinePtr = eolPtr ? (eolPtr + 1) : endPtr;
+		size_t	lineLength = (eolPtr ? eolPtr : endPtr) - linePtr;
+		if (lineLength && linePtr[lineLength - 1] == '\r')
+		{
+			lineLength--;
+		}
+		if (lineLength)
+		{
+			outTimes[count++] = Parse(linePtr, lineLength, timestamp) ?
+						(inLocal ? timestamp.Local() : timestamp.UTC()) : 0;
+		}
+		linePtr = nextLinePtr;
+	}
+	if (outConsumed)
+	{
+		*outConsumed = linePtr - inBuffer;
+	}
+	return(count);
+}
@@ -0,0 +1,173 @@
+/*
+*	UnixClock.cpp, Copyright Jonathan Mackey 2026
+*
+*	A clock holding the current Unix time and everything derived from it.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "UnixClock.h"
+#include "CivilCalendar.h"
+
+// SLEEP_DELAY : If no activity after SLEEP_DELAY seconds, go to sleep
+// This can also be set via SetSleepDelay()
+#define SLEEP_DELAY	90
+
+/********************************* UnixClock **********************************/
+UnixClock::UnixClock(
+	time32_t	inTime)
+	: mTime(inTime), mTimeChanged(false), mFormat24Hour(false),
+	  mGeneration(0), mSubsecondCounter(nullptr), mSubsecondTicksPerSecond(0),
+	  mSleepTime(0), mSleepDelay(SLEEP_DELAY), mLeapSecondTick(0),
+	  mLeapSecondDelta(0)
+{
+	SyncComponents();
+}
+
+/********************************** SetTime ***********************************/
+/*
+*	Sets the time and everything derived from it as a single seqlock write.
+*	Any scheduled leap second is cancelled, it was scheduled for the time
+*	being replaced.
+*/
+void UnixClock::SetTime(
+	time32_t	inTime)
+{
+	mLock.WriteBegin();
+	SequenceLock::Store(mTime, inTime);
+	SyncComponents();
+	mLeapSecondDelta = 0;
+	SequenceLock::Store(mGeneration, mGeneration + 1);
+	mLock.WriteEnd();
+}
+
+/***************************** ScheduleLeapSecond *****************************/
+void UnixClock::ScheduleLeapSecond(
+	time32_t	inTime,
+	int8_t		inDelta)
+{
+	/*
+	*	A positive leap second follows the tick into 23:59:59, a negative one
+	*	replaces the tick into 23:59:59.  mLeapSecondDelta arms it, so it's
+	*	set last.
+	*/
+	mLeapSecondDelta = 0;
+	mLeapSecondTick = inDelta > 0 ? (inTime - 1) : (inTime - 2);
+	mLeapSecondDelta = inDelta;
+}
+
+/********************************** Snapshot **********************************/
+UnixClock::STimeSnapshot UnixClock::Snapshot(void) const
+{
+	STimeSnapshot	snapshot;
+	uint32_t		sequence;
+	do
+	{
+		sequence = mLock.ReadBegin();
+		snapshot.seconds = SequenceLock::Load(mTime);
+		snapshot.generation = SequenceLock::Load(mGeneration);
+		snapshot.subsecond = mSubsecondCounter ? *mSubsecondCounter : 0;
+	} while (mLock.ReadRetry(sequence));
+	/*
+	*	The counter may briefly reach inTicksPerSecond before the ISR that
+	*	calls Tick() resets it.
+	*/
+	if (snapshot.subsecond >= mSubsecondTicksPerSecond &&
+		mSubsecondTicksPerSecond)
+	{
+		snapshot.subsecond = mSubsecondTicksPerSecond - 1;
+	}
+	return(snapshot);
+}
+
+/***************************** SetSubsecondSource *****************************/
+void UnixClock::SetSubsecondSource(
+	const volatile uint32_t*	inCounter,
+	uint32_t					inTicksPerSecond)
+{
+	mSubsecondCounter = inCounter;
+	mSubsecondTicksPerSecond = inTicksPerSecond;
+}
+
+/******************************* SyncComponents *******************************/
+/*
+*	Re-derives the incrementally maintained components from mTime.  Called
+*	whenever the time is set rather than ticked.
+*/
+void UnixClock::SyncComponents(void)
+{
+	ToComponents(mTime, mComponents);
+	mDayOfYear = CivilCalendar::DayOfYear(mComponents.year,
+											mComponents.month,
+											mComponents.day);
+	mDayOfWeek = DayOfWeek(mTime);
+}
+
+/******************************** CarryMinute *********************************/
+/*
+*	Called by Tick() when the seconds roll over.  Carries into the minutes,
+*	hours, day, month and year without any division.
+*/
+void UnixClock::CarryMinute(void)
+{
+	mComponents.second = 0;
+	if (++mComponents.minute >= 60)
+	{
+		mComponents.minute = 0;
+		if (++mComponents.hour >= 24)
+		{
+			mComponents.hour = 0;
+			mDayOfWeek = mDayOfWeek < 6 ? (mDayOfWeek + 1) : 0;
+			mDayOfYear++;
+			if (++mComponents.day >
+				CivilCalendar::DaysInMonth(mComponents.month, mComponents.year))
+			{
+				mComponents.day = 1;
+				if (++mComponents.month > 12)
+				{
+					mComponents.month = 1;
+					mComponents.year++;
+					mDayOfYear = 1;
+				}
+			}
+		}
+	}
+}
+
+/******************************* LeapSecondTick *******************************/
+/*
+*	Called by Tick() in place of the normal tick when mTime is
+*	mLeapSecondTick and a leap second is scheduled.
+*/
+void UnixClock::LeapSecondTick(void)
+{
+	if (mLeapSecondDelta > 0)
+	{
+		if (mComponents.second == 59)
+		{
+			mComponents.second = 60;	// 23:59:60, mTime holds
+			return;
+		}
+		SequenceLock::Store(mTime, mTime + 1);
+	} else
+	{
+		SequenceLock::Store(mTime, mTime + 2);
+	}
+	mLeapSecondDelta = 0;
+	CarryMinute();
+}
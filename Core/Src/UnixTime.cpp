@@ -21,6 +21,9 @@
 *
 */
 #include "UnixTime.h"
+#include "CivilCalendar.h"
+#include "TimestampParser.h"
+#include "DateTimeFormat.h"
 #ifdef SUPPORT_DSDateTime
 #include <Arduino.h>
 //#include <avr/pgmspace.h>
@@ -39,7 +42,12 @@
 #define sei()
 #endif
 
-#ifdef STM32_CUBE_
+#ifdef __linux__
+#include <ctime>
+#include "TimeZoneRule.h"
+#endif
+
+#if defined STM32_CUBE_ || defined __linux__
 #include <cstring>
 #define PROGMEM
 #define pgm_read_word(xx) *(xx)
@@ -52,14 +60,8 @@
 #ifdef SUPPORT_DSDateTime
 DS3231SN*		UnixTime::sExternalRTC;
 #endif
-time32_t		UnixTime::sTime;
-bool			UnixTime::sTimeChanged;
+UnixClock		UnixTime::sClock;
 
-// SLEEP_DELAY : If no activity after SLEEP_DELAY seconds, go to sleep
-// This can also be set via UnixTime::SetSleepDelay()
-#define SLEEP_DELAY	90
-time32_t			UnixTime::sSleepTime;
-uint32_t			UnixTime::sSleepDelay = SLEEP_DELAY;
 // date +%s		<< Unix command to get the local time
 
 // https://www.epochconverter.com
@@ -68,41 +70,23 @@ uint32_t			UnixTime::sSleepDelay = SLEEP_DELAY;
 const uint8_t	UnixTime::kOneMinute = 60;
 const uint16_t	UnixTime::kOneHour = 3600;
 const uint32_t	UnixTime::kOneDay = 86400;
-const uint32_t	kDaysInFourYears = 1461;
 const uint32_t	UnixTime::kOneYear = 31557600;
 const time32_t	UnixTime::kYear2000 = 946684800;	// Seconds from 1970 to 2000
-const uint8_t	UnixTime::kDaysInMonth[] PROGMEM = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 const uint16_t	UnixTime::kDaysTo[] PROGMEM = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
-const uint16_t	UnixTime::kDaysToLY[] PROGMEM = {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335};
-bool			UnixTime::sFormat24Hour;	// false = 12, true = 24
-const char		UnixTime::kMonth3LetterAbbr[] PROGMEM = "JANFEBMARAPRMAYJUNJULAUGSEPOCTNOVDEC";
-const char		UnixTime::kDay3LetterAbbr[] PROGMEM = "SUNMONTUEWEDTHUFRISAT";
 
+DATE_TIME_FORMAT(DateFormat, "%d-%b-%Y");
+DATE_TIME_FORMAT(TimeFormat, "%H:%M:%S");
+DATE_TIME_FORMAT(MonthFormat, "%b");
+DATE_TIME_FORMAT(DayOfWeekFormat, "%a");
 
 #ifdef SUPPORT_DSDateTime
 /**************************** DSDateTimeToUnixTime ****************************/
 time32_t UnixTime::DSDateTimeToUnixTime(
 	const DSDateTime&	inDSDateTime)
 {
-	time32_t time = kYear2000;
-	time += (inDSDateTime.dt.year * 31536000);
-	{
-		uint16_t	days = pgm_read_word(&kDaysTo[inDSDateTime.dt.month-1])
-								+ inDSDateTime.dt.date;
-		/*
-		*	If past February AND
-		*	year is a leap year THEN
-		*	add a day
-		*/
-		if (inDSDateTime.dt.month > 2 &&
-			(inDSDateTime.dt.year % 4) == 0)
-		{
-			days++;
-		}
-		// Account for leap year days since 2000
-		days += (((inDSDateTime.dt.year+3)/4)-1);
-		time += (days * kOneDay);
-	}
+	time32_t time = (CivilCalendar::DaysFromCivil(inDSDateTime.dt.year + 2000,
+						inDSDateTime.dt.month, inDSDateTime.dt.date) -
+							CivilCalendar::kUnixEpochDays) * kOneDay;
 	time += (((uint32_t)inDSDateTime.dt.hour) * kOneHour);
 	time += (inDSDateTime.dt.minute * kOneMinute);
 	time += inDSDateTime.dt.second;
@@ -130,12 +114,12 @@ void UnixTime::SetTime(
 	time32_t	inTime)
 {
 	#if defined ESP_H
-		sTime = inTime;
+		sClock.SetTime(inTime);
 	#elif  defined _STM32_DEF_
-		sTime = inTime;
+		sClock.SetTime(inTime);
 	#else
 		cli();
-		sTime = inTime;
+		sClock.SetTime(inTime);
 		sei();
 	#endif
 	if (sExternalRTC)
@@ -150,7 +134,7 @@ void UnixTime::SetTime(
 void UnixTime::SetTime(
 	time32_t	inTime)
 {
-	sTime = inTime;
+	sClock.SetTime(inTime);
 }
 #endif
 
@@ -161,7 +145,19 @@ void UnixTime::SetTimeFromExternalRTC(void)
 	CFTimeZoneRef tz = CFTimeZoneCopySystem();
 	time32_t localTime = (time32_t)(time(nullptr) + CFTimeZoneGetSecondsFromGMT(tz, 0));
 	CFRelease(tz);
-	sTime = localTime;
+	sClock.SetTime(localTime);
+}
+#elif defined __linux__
+/*************************** SetTimeFromExternalRTC ***************************/
+/*
+*	Sets the time to the host's local time per the TZ environment variable or
+*	/etc/localtime.
+*/
+void UnixTime::SetTimeFromExternalRTC(void)
+{
+	TimeZoneRule	timeZone;
+	timeZone.ParseSystemTimeZone();
+	sClock.SetTime(timeZone.UTCToLocal((time32_t)time(nullptr)));
 }
 #elif defined SUPPORT_DSDateTime
 /*************************** SetTimeFromExternalRTC ***************************/
@@ -175,12 +171,12 @@ void UnixTime::SetTimeFromExternalRTC(void)
 		time32_t time = DSDateTimeToUnixTime(dateAndTime);
 		
 	#if defined ESP_H
-		sTime = time;
+		sClock.SetTime(time);
 	#elif  defined _STM32_DEF_
-		sTime = time;
+		sClock.SetTime(time);
 	#else
 		cli();
-		sTime = time;
+		sClock.SetTime(time);
 		sei();
 	#endif
 	}
@@ -203,8 +199,8 @@ void UnixTime::SetTimeFromExternalRTC(void)
 *	
 *	The timezone is in quarter hours off of GMT.  e.g. -18 = -04:30:0.  
 *
-*	When parsing for timezone, quotes and commas are ignored.
-*	No format validation is performed (shit in, shit out.)
+*	Any of the other formats supported by TimestampParser are also accepted.
+*	Returns 0 if the string isn't valid.
 *
 *	Ex 21/07/26,13:25:53-16" = 26-JUL-2021 1:25PM
 *	If inAdjustForTimezone
@@ -214,60 +210,17 @@ time32_t UnixTime::StringToUnixTime(
 	const char*	inDateTimeStr,
 	bool		inAdjustForTimezone)
 {
-	time32_t time = kYear2000;
-	uint8_t	year = StrDecValue(&inDateTimeStr[0]);
-	if (year < 80)
-	{
-		time += (year * 31536000);
-		{
-			uint8_t		month = StrDecValue(&inDateTimeStr[3]) -1;
-			uint16_t	days = pgm_read_word(&kDaysTo[month]) + StrDecValue(&inDateTimeStr[6]);
-			/*
-			*	If past February AND
-			*	year is a leap year THEN
-			*	add a day
-			*/
-			if (month > 2 &&
-				(year % 4) == 0)
-			{
-				days++;
-			}
-			// Account for leap year days since 2000
-			days += (((year+3)/4)-1);
-			time += (days * kOneDay);
-		}
-		time += ((uint32_t)StrDecValue(&inDateTimeStr[9]) * kOneHour);
-		time += (StrDecValue(&inDateTimeStr[12]) * kOneMinute);
-		time += StrDecValue(&inDateTimeStr[15]);
-		if (inAdjustForTimezone)
-		{
-			const char*	tzPtr = &inDateTimeStr[17];
-			char thisChar = *(tzPtr++);
-			for (; thisChar; thisChar = *(tzPtr++))
-			{
-				// Ignore quotes and commas
-				if (thisChar == '\"' ||
-					thisChar == ',')
-				{
-					continue;
-				}
-				uint16_t tzAdjustment = StrDecValue(tzPtr) * kOneMinute * 15;
-				if (thisChar == '-')
-				{
-					time -= tzAdjustment;
-				} else
-				{
-					time += tzAdjustment;
-				}
-				break;
-			}
-		}
-	} else
+	TimestampParser::STimestamp	timestamp;
+	time32_t time = 0;
+	/*
+	*	A year >= 80 is rejected by the parser.  This only happens after the
+	*	battery has been removed and there has been no connection to a cell
+	*	tower or automatic time updates have not been enabled by sending
+	*	AT+CLTS=1 to the modem.
+	*/
+	if (TimestampParser::Parse(inDateTimeStr, strlen(inDateTimeStr), timestamp))
 	{
-		// Only happens after the battery has been removed and there has been
-		// no connection to a cell tower or automatic time updates have not been
-		// enabled by sending AT+CLTS=1 to the modem.
-		time = 0;
+		time = inAdjustForTimezone ? timestamp.Local() : timestamp.time;
 	}
 	return(time);
 }
@@ -276,77 +229,13 @@ time32_t UnixTime::StringToUnixTime(
 /*
 *	Converts a pair of strings to Unix time.
 *	inDateStr is of the form Mmm-DD-YYYY, where the month is a 3 letter English
-*	abbreviation.  The last two letters must be lowercase.
+*	abbreviation in any case.  Returns 0 if either string isn't valid.
 */
 time32_t UnixTime::StringToUnixTime(
 	const char*	inDateStr,
 	const char*	inTimeStr)
 {
-	time32_t time = kYear2000;
-	uint8_t	year = StrDecValue(&inDateStr[9]);
-	time += (year * 31536000);
-    // Jan Feb Mar Apr May Jun Jul Aug Sep Oct Nov Dec
-    {
-		uint8_t	month;
-		switch (inDateStr[1]+inDateStr[2])
-		{
-		case 199:
-			month = 1;
-			break;
-		case 200:
-			month = 11;
-			break;
-		case 207:
-			month = 0;
-			break;
-		case 211:
-			month = 2;
-			break;
-		case 213:
-			month = 8;
-			break;
-		case 215:
-			month = 9;
-			break;
-		case 218:
-			month = 4;
-			break;
-		case 220:
-			month = 7;
-			break;
-		case 225:
-			month = 6;
-			break;
-		case 226:
-			month = 3;
-			break;
-		case 227:
-			month = 5;
-			break;
-		default:
-		case 229:
-			month = 10;
-			break;
-		}
-		uint16_t	days = pgm_read_word(&kDaysTo[month]) + StrDecValue(&inDateStr[4]);
-		/*
-		*	If past February AND
-		*	year is a leap year THEN
-		*	add a day
-		*/
-		if (month > 2 &&
-			(year % 4) == 0)
-		{
-			days++;
-		}
-		// Account for leap year days since 2000
-		days += (((year+3)/4)-1);
-		time += (days * kOneDay);
-	}
-	time += ((uint32_t)StrDecValue(&inTimeStr[0]) * kOneHour);
-	time += (StrDecValue(&inTimeStr[3]) * kOneMinute);
-	time += StrDecValue(&inTimeStr[6]);
-	return(time);
+	return(TimestampParser::ParseMonthDateAndTime(inDateStr, inTimeStr));
 }
 
 /******************************** StrDecValue *********************************/
@@ -362,91 +251,6 @@ uint8_t UnixTime::StrDecValue(
 	return((value*10) + in2ByteStr[1] - '0');
 }
 
-/******************************** ToComponents ********************************/
-void UnixTime::ToComponents(
-	time32_t		inTime,
-	SComponents&	outComponents)
-{
-	TimeComponents(DateComponents(inTime,
-									outComponents.year,
-									outComponents.month,
-									outComponents.day),
-									outComponents.hour,
-									outComponents.minute,
-									outComponents.second);
-}
-
-/******************************* FromComponents *******************************/
-time32_t UnixTime::FromComponents(
-	const SComponents&	inComponents)
-{
-	time32_t time = kYear2000;
-	uint16_t	year = inComponents.year % 2000;
-	time += (year * 31536000);
-	{
-		uint16_t	days = pgm_read_word(&kDaysTo[inComponents.month-1])
-								+ inComponents.day;
-		/*
-		*	If past February AND
-		*	year is a leap year THEN
-		*	add a day
-		*/
-		if (inComponents.month > 2 &&
-			(year % 4) == 0)
-		{
-			days++;
-		}
-		// Account for leap year days since 2000
-		days += (((year+3)/4)-1);
-		time += (days * kOneDay);
-	}
-	time += (((uint32_t)inComponents.hour) * kOneHour);
-	time += (inComponents.minute * kOneMinute);
-	time += inComponents.second;
-	return(time);
-}
-
-/******************************* TimeComponents *******************************/
-void UnixTime::TimeComponents(
-	time32_t	inTime,
-	uint8_t&	outHour,
-	uint8_t&	outMinute,
-	uint8_t&	outSecond)
-{
-	outSecond = inTime % 60;
-	inTime /= 60;
-	outMinute = inTime % 60;
-	inTime /= 60;
-	outHour = inTime % 24;
-}
-
-/******************************* DateComponents *******************************/
-time32_t UnixTime::DateComponents(
-	time32_t	inTime,
-	uint16_t&	outYear,
-	uint8_t&	outMonth,
-	uint8_t&	outDay)
-{
-	inTime -= (365*2*kOneDay);	// Start from 1972, the first leap year after 1970
-	time32_t	timeComp = inTime%kOneDay;
-	inTime -= timeComp;
-	outYear = (inTime/kOneYear) + 1972;
-	uint16_t	day = ((inTime % kOneYear) / kOneDay) + 1;
-	const uint16_t*	daysTo = ((inTime/kOneDay) % kDaysInFourYears) <= 365 ? kDaysToLY : kDaysTo;
-	uint8_t month = 1;
-	for (; month < 12; month++)
-	{
-		if (day > pgm_read_word(&daysTo[month]))
-		{
-			continue;
-		}
-		break;
-	}
-	outMonth = month;
-	outDay = day - pgm_read_word(&daysTo[month-1]);
-	return(timeComp);
-}
-
 /******************************* CreateDateStr ********************************/
 /*
 *	Creates a date string of the form dd-MON-yyyy (12 bytes including nul)
@@ -455,15 +259,7 @@ void UnixTime::CreateDateStr(
 	time32_t	inTime,
 	char*		outDateStr)
 {
-	uint16_t	year;
-	uint8_t		month;
-	uint8_t		day;
-	DateComponents(inTime, year, month, day);
-	DecStrValue(day, outDateStr);
-	outDateStr[2] = '-';
-	memcpy_P(&outDateStr[3], &kMonth3LetterAbbr[(month-1)*3], 3);
-	outDateStr[6] = '-';
-	Uint16ToDecStr(year, &outDateStr[7]);
+	DateFormat::Format(inTime, outDateStr);
 }
 
 /******************************* CreateMonthStr *******************************/
@@ -476,8 +272,9 @@ void UnixTime::CreateMonthStr(
 	uint8_t		inMonth,
 	char*		outMonthStr)
 {
-	memcpy_P(outMonthStr, &kMonth3LetterAbbr[(inMonth-1)*3], 3);
-	outMonthStr[3] = 0;
+	DateTimeFormatter::SFields	fields;
+	fields.components.month = inMonth;
+	MonthFormat::Format(fields, outMonthStr);
 }
 
 /***************************** CreateDayOfWeekStr *****************************/
@@ -488,8 +285,7 @@ void UnixTime::CreateDayOfWeekStr(
 	time32_t	inTime,
 	char*		outDayStr)
 {
-	memcpy_P(outDayStr, &kDay3LetterAbbr[DayOfWeek(inTime)*3], 3);
-	outDayStr[3] = 0;
+	DayOfWeekFormat::Format(inTime, outDayStr);
 }
 
 /***************************** DaysInMonthForYear *****************************/
@@ -501,16 +297,7 @@ uint8_t UnixTime::DaysInMonthForYear(
 	uint8_t		inMonth,
 	uint16_t	inYear)
 {
-	uint8_t	daysInMonth;
-	if (inMonth != 2 ||
-		(inYear % 4) != 0)
-	{
-		daysInMonth = pgm_read_byte(&kDaysInMonth[inMonth-1]);
-	} else
-	{
-		daysInMonth = 29;
-	}
-	return(daysInMonth);
+	return(CivilCalendar::DaysInMonth(inMonth, inYear));
 }
 
 /******************************* CreateTimeStr ********************************/
@@ -519,8 +306,10 @@ bool UnixTime::CreateTimeStr(
 	char*		outTimeStr)
 {
 	bool notElapsedTime = inTime > kOneYear;
-	uint8_t	hour, minute, second;
-	TimeComponents(inTime, hour, minute, second);
+	DateTimeFormatter::SFields	fields;
+	uint8_t&	hour = fields.components.hour;
+	TimeComponents(inTime, hour, fields.components.minute,
+						fields.components.second);
 	bool isPM = hour >= 12;
 	/*
 	*	If using a 12 hour format AND
@@ -528,28 +317,25 @@ bool UnixTime::CreateTimeStr(
 	*	the hour is past noon THEN
 	*	adjust the hour.
 	*/
-	if (!sFormat24Hour &&
+	if (!sClock.Format24Hour() &&
 		notElapsedTime &&
 		hour > 12)
 	{
 		hour -= 12;
 	}
-	DecStrValue(hour, outTimeStr);
-	outTimeStr[2] = ':';
-	DecStrValue(minute, &outTimeStr[3]);
-	outTimeStr[5] = ':';
-	DecStrValue(second, &outTimeStr[6]);
-	outTimeStr[8] = 0;
+	TimeFormat::Format(fields, outTimeStr);
 	return(isPM);
 }
 
 /******************************** DecStrValue *********************************/
+/*
+*	inDecVal must be less than 100.
+*/
 void UnixTime::DecStrValue(
 	uint8_t		inDecVal,
 	char*		outByteStr)
 {
-	outByteStr[0] = (inDecVal / 10) + '0';
-	outByteStr[1] = (inDecVal % 10) + '0';
+	DateTimeFormatter::Write2Digits(inDecVal, outByteStr);
 }
 
 /******************************* Uint16ToDecStr *******************************/
@@ -557,13 +343,7 @@ void UnixTime::Uint16ToDecStr(
 	uint16_t	inNum,
 	char*		inBuffer)
 {
-	for (uint16_t num = inNum; num/=10; inBuffer++);
-	inBuffer[1] = 0;
-	do
-	{
-		*(inBuffer--) = (inNum % 10) + '0';
-		inNum /= 10;
-	} while (inNum);
+	DateTimeFormatter::WriteUint16(inNum, inBuffer);
 }
 
 /********************************** SetTime ***********************************/
@@ -571,7 +351,7 @@ void UnixTime::SetTime(
 	const char*	inDateStr,
 	const char*	inTimeStr)
 {
-	sTime = StringToUnixTime(inDateStr, inTimeStr);
+	sClock.SetTime(StringToUnixTime(inDateStr, inTimeStr));
 }
 
 /******************************* SDFatDateTime ********************************/
@@ -601,7 +381,7 @@ void UnixTime::SDFatDateTimeCB(
 	SDFatDateTime(Time(), outDate, outTime);
 }
 
-#if !defined __MACH__ && !defined STM32_CUBE_
+#if !defined __MACH__ && !defined STM32_CUBE_ && !defined __linux__
 /*************************** SetUnixTimeFromSerial ****************************/
 void UnixTime::SetUnixTimeFromSerial(void)
 {
@@ -614,17 +394,3 @@ void UnixTime::SetUnixTimeFromSerial(void)
 	ResetSleepTime();
 }
 #endif
-
-/******************************* SetSleepDelay ********************************/
-void UnixTime::SetSleepDelay(
-	uint32_t	inDelaySeconds)
-{
-	sSleepDelay = inDelaySeconds;
-}
-
-/******************************* ResetSleepTime *******************************/
-void UnixTime::ResetSleepTime(void)
-{
-	sSleepTime = sTime + sSleepDelay;
-}
-
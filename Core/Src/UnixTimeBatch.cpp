@@ -0,0 +1,325 @@
+/*
+*	UnixTimeBatch.cpp, Copyright Jonathan Mackey 2026
+*
+*	Converts arrays of time32_t values to date/time components.
+*
+*	The vector path is a lane-parallel copy of UnixTimeConverter::ToComponents
+*	and CivilCalendar::CivilFromDays.  Each constant division is replaced by
+*	a multiply-high by a magic reciprocal followed by a shift.  Every
+*	reciprocal below was chosen so that the quotient is exact over the full
+*	range of the dividend it is applied to, which is what makes the results
+*	identical to the scalar path.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "UnixTimeBatch.h"
+#include "CivilCalendar.h"
+
+// Define UNIX_TIME_BATCH_SCALAR to use the scalar loop on any target.
+#if (defined __AVX2__ || defined __SSE2__) && !defined UNIX_TIME_BATCH_SCALAR
+#include <immintrin.h>
+#include <string.h>
+#define UNIX_TIME_BATCH_SIMD	1
+#endif
+
+#ifdef UNIX_TIME_BATCH_SIMD
+static_assert(sizeof(SUnixTimeComponents) == 8 &&
+	offsetof(SUnixTimeComponents, year) == 6, "Unexpected SComponents layout");
+
+#ifdef __AVX2__
+/*
+*	8 x 32 bit lanes.
+*/
+struct SVector
+{
+	typedef __m256i	V;
+	static const size_t	kLanes = 8;
+	static inline V		Load(const time32_t* inPtr)
+							{return(_mm256_loadu_si256((const V*)inPtr));}
+	static inline V		Set1(uint32_t inValue)
+							{return(_mm256_set1_epi32((int)inValue));}
+	static inline V		Add(V inA, V inB)
+							{return(_mm256_add_epi32(inA, inB));}
+	static inline V		Sub(V inA, V inB)
+							{return(_mm256_sub_epi32(inA, inB));}
+	static inline V		And(V inA, V inB)
+							{return(_mm256_and_si256(inA, inB));}
+	static inline V		Or(V inA, V inB)
+							{return(_mm256_or_si256(inA, inB));}
+	static inline V		ShiftRight(V inA, int inBits)
+							{return(_mm256_srli_epi32(inA, inBits));}
+	static inline V		ShiftLeft(V inA, int inBits)
+							{return(_mm256_slli_epi32(inA, inBits));}
+	static inline V		CompareGreater(V inA, V inB)	// signed
+							{return(_mm256_cmpgt_epi32(inA, inB));}
+	static inline V		MulLo(V inA, V inB)
+							{return(_mm256_mullo_epi32(inA, inB));}
+	/*
+	*	High 32 bits of the unsigned 64 bit product.
+	*/
+	static inline V		MulHi(V inA, V inB)
+							{
+								V	even = _mm256_srli_epi64(_mm256_mul_epu32(inA, inB), 32);
+								V	odd = _mm256_mul_epu32(_mm256_srli_epi64(inA, 32),
+																_mm256_srli_epi64(inB, 32));
+								return(_mm256_blend_epi32(even, odd, 0xAA));
+							}
+	/*
+	*	Product of values less than 2^15 using the 16 bit multiply-add.
+	*/
+	static inline V		MulLoSmall(V inA, V inB)
+							{return(_mm256_madd_epi16(inA, inB));}
+	/*
+	*	Interleaves the low and high words of 8 records and stores them.
+	*/
+	static inline void	StoreRecords(void* outPtr, V inLo, V inHi)
+							{
+								V	r0145 = _mm256_unpacklo_epi32(inLo, inHi);
+								V	r2367 = _mm256_unpackhi_epi32(inLo, inHi);
+								_mm256_storeu_si256((V*)outPtr,
+									_mm256_permute2x128_si256(r0145, r2367, 0x20));
+								_mm256_storeu_si256(((V*)outPtr) + 1,
+									_mm256_permute2x128_si256(r0145, r2367, 0x31));
+							}
+	static inline __m128i	Narrow(V inA)
+							{return(_mm_packs_epi32(_mm256_castsi256_si128(inA),
+										_mm256_extracti128_si256(inA, 1)));}
+	static inline void	StoreBytes(uint8_t* outPtr, V inA)
+							{
+								__m128i	halfwords = Narrow(inA);
+								_mm_storel_epi64((__m128i*)outPtr,
+									_mm_packus_epi16(halfwords, halfwords));
+							}
+	static inline void	StoreHalfwords(uint16_t* outPtr, V inA)
+							{_mm_storeu_si128((__m128i*)outPtr, Narrow(inA));}
+};
+#else
+/*
+*	4 x 32 bit lanes.  SSE2 has no 32 bit multiply low or high, so both are
+*	built from the even/odd lane 32x32->64 multiply.
+*/
+struct SVector
+{
+	typedef __m128i	V;
+	static const size_t	kLanes = 4;
+	static inline V		Load(const time32_t* inPtr)
+							{return(_mm_loadu_si128((const V*)inPtr));}
+	static inline V		Set1(uint32_t inValue)
+							{return(_mm_set1_epi32((int)inValue));}
+	static inline V		Add(V inA, V inB)
+							{return(_mm_add_epi32(inA, inB));}
+	static inline V		Sub(V inA, V inB)
+							{return(_mm_sub_epi32(inA, inB));}
+	static inline V		And(V inA, V inB)
+							{return(_mm_and_si128(inA, inB));}
+	static inline V		Or(V inA, V inB)
+							{return(_mm_or_si128(inA, inB));}
+	static inline V		ShiftRight(V inA, int inBits)
+							{return(_mm_srli_epi32(inA, inBits));}
+	static inline V		ShiftLeft(V inA, int inBits)
+							{return(_mm_slli_epi32(inA, inBits));}
+	static inline V		CompareGreater(V inA, V inB)	// signed
+							{return(_mm_cmpgt_epi32(inA, inB));}
+	static inline V		MulLo(V inA, V inB)
+							{
+								V	even = _mm_mul_epu32(inA, inB);
+								V	odd = _mm_mul_epu32(_mm_srli_epi64(inA, 32),
+															_mm_srli_epi64(inB, 32));
+								return(_mm_unpacklo_epi32(
+										_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)),
+										_mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0))));
+							}
+	static inline V		MulHi(V inA, V inB)
+							{
+								V	even = _mm_mul_epu32(inA, inB);
+								V	odd = _mm_mul_epu32(_mm_srli_epi64(inA, 32),
+															_mm_srli_epi64(inB, 32));
+								return(_mm_unpacklo_epi32(
+										_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,3,1)),
+										_mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,3,1))));
+							}
+	static inline V		MulLoSmall(V inA, V inB)
+							{return(_mm_madd_epi16(inA, inB));}
+	static inline void	StoreRecords(void* outPtr, V inLo, V inHi)
+							{
+								_mm_storeu_si128((V*)outPtr, _mm_unpacklo_epi32(inLo, inHi));
+								_mm_storeu_si128(((V*)outPtr) + 1, _mm_unpackhi_epi32(inLo, inHi));
+							}
+	static inline void	StoreBytes(uint8_t* outPtr, V inA)
+							{
+								V	halfwords = _mm_packs_epi32(inA, inA);
+								int32_t	bytes = _mm_cvtsi128_si32(_mm_packus_epi16(halfwords, halfwords));
+								memcpy(outPtr, &bytes, 4);
+							}
+	static inline void	StoreHalfwords(uint16_t* outPtr, V inA)
+							{_mm_storel_epi64((V*)outPtr, _mm_packs_epi32(inA, inA));}
+};
+#endif
+
+struct SLanes
+{
+	SVector::V	second;
+	SVector::V	minute;
+	SVector::V	hour;
+	SVector::V	day;
+	SVector::V	month;
+	SVector::V	year;
+};
+
+/******************************** ConvertLanes ********************************/
+/*
+*	Converts SVector::kLanes times starting at inTimes.
+*
+*	The (magic, shift) pairs are exact for the following dividend ranges:
+*		x/675		(50903317, 3)	x < 2^25 (time >> 7)
+*		x/3600		(1193047, 0)	x < 86400
+*		x/60		(71582789, 0)	x < 3600
+*		x/146097	(3762951, 7)	x < 3100000
+*		x/11758980	(1531969483, 22) any 32 bit x
+*		x/2141		(2006057, 0)	x < 65536
+*
+*	MulLoSmall is only used where both factors are less than 2^15.
+*/
+static inline void ConvertLanes(
+	const time32_t*	inTimes,
+	SLanes&			outLanes)
+{
+	typedef SVector::V	V;
+	V	time = SVector::Load(inTimes);
+	// days = time / 86400 = (time >> 7) / 675
+	V	days = SVector::ShiftRight(
+					SVector::MulHi(SVector::ShiftRight(time, 7),
+									SVector::Set1(50903317)), 3);
+	V	secondOfDay = SVector::Sub(time,
+					SVector::MulLo(days, SVector::Set1(86400)));
+	V	hour = SVector::MulHi(secondOfDay, SVector::Set1(1193047));
+	V	secondOfHour = SVector::Sub(secondOfDay,
+					SVector::MulLoSmall(hour, SVector::Set1(3600)));
+	V	minute = SVector::MulHi(secondOfHour, SVector::Set1(71582789));
+	V	second = SVector::Sub(secondOfHour,
+					SVector::MulLoSmall(minute, SVector::Set1(60)));
+
+	// CivilCalendar::CivilFromDays
+	V	n1 = SVector::Add(SVector::ShiftLeft(SVector::Add(days,
+					SVector::Set1(CivilCalendar::kUnixEpochDays)), 2),
+						SVector::Set1(3));
+	V	century = SVector::ShiftRight(
+					SVector::MulHi(n1, SVector::Set1(3762951)), 7);
+	V	n2 = SVector::Or(SVector::Sub(n1,
+					SVector::MulLo(century, SVector::Set1(146097))),
+						SVector::Set1(3));
+	V	yearOfCentury = SVector::MulHi(n2, SVector::Set1(2939745));
+	V	p2Lo = SVector::MulLo(n2, SVector::Set1(2939745));
+	V	dayOfYear = SVector::ShiftRight(
+					SVector::MulHi(p2Lo, SVector::Set1(1531969483)), 22);
+	V	n3 = SVector::Add(SVector::MulLoSmall(dayOfYear, SVector::Set1(2141)),
+					SVector::Set1(197913));
+	V	month = SVector::ShiftRight(n3, 16);
+	V	day = SVector::MulHi(SVector::And(n3, SVector::Set1(0xFFFF)),
+					SVector::Set1(2006057));
+	V	janFeb = SVector::CompareGreater(dayOfYear, SVector::Set1(305));	// 0 or -1
+	V	year = SVector::Sub(SVector::Add(
+					SVector::MulLoSmall(century, SVector::Set1(100)), yearOfCentury),
+						janFeb);
+	month = SVector::Sub(month, SVector::And(janFeb, SVector::Set1(12)));
+	day = SVector::Add(day, SVector::Set1(1));
+
+	outLanes.second = second;
+	outLanes.minute = minute;
+	outLanes.hour = hour;
+	outLanes.day = day;
+	outLanes.month = month;
+	outLanes.year = year;
+}
+#endif
+
+/***************************** ToComponentsBatch ******************************/
+void UnixTimeBatch::ToComponentsBatch(
+	const time32_t*	inTimes,
+	size_t			inCount,
+	SComponents*	outComponents)
+{
+	size_t	i = 0;
+#ifdef UNIX_TIME_BATCH_SIMD
+	SLanes	lanes;
+	for (; (i + SVector::kLanes) <= inCount; i += SVector::kLanes)
+	{
+		ConvertLanes(&inTimes[i], lanes);
+		/*
+		*	Each 8 byte SComponents is assembled as two 32 bit words:
+		*	second|minute|hour|day and month|pad|year.
+		*/
+		SVector::StoreRecords(&outComponents[i],
+			SVector::Or(SVector::Or(lanes.second,
+								SVector::ShiftLeft(lanes.minute, 8)),
+						SVector::Or(SVector::ShiftLeft(lanes.hour, 16),
+								SVector::ShiftLeft(lanes.day, 24))),
+			SVector::Or(lanes.month, SVector::ShiftLeft(lanes.year, 16)));
+	}
+#endif
+	for (; i < inCount; i++)
+	{
+		UnixTimeConverter<time32_t>::ToComponents(inTimes[i], outComponents[i]);
+	}
+}
+
+/***************************** ToComponentsBatch ******************************/
+void UnixTimeBatch::ToComponentsBatch(
+	const time32_t*			inTimes,
+	size_t					inCount,
+	const SComponentsSoA&	outComponents)
+{
+	size_t	i = 0;
+#ifdef UNIX_TIME_BATCH_SIMD
+	SLanes	lanes;
+	for (; (i + SVector::kLanes) <= inCount; i += SVector::kLanes)
+	{
+		ConvertLanes(&inTimes[i], lanes);
+		SVector::StoreBytes(&outComponents.second[i], lanes.second);
+		SVector::StoreBytes(&outComponents.minute[i], lanes.minute);
+		SVector::StoreBytes(&outComponents.hour[i], lanes.hour);
+		SVector::StoreBytes(&outComponents.day[i], lanes.day);
+		SVector::StoreBytes(&outComponents.month[i], lanes.month);
+		SVector::StoreHalfwords(&outComponents.year[i], lanes.year);
+	}
+#endif
+	for (; i < inCount; i++)
+	{
+		SComponents	components;
+		UnixTimeConverter<time32_t>::ToComponents(inTimes[i], components);
+		outComponents.second[i] = components.second;
+		outComponents.minute[i] = components.minute;
+		outComponents.hour[i] = components.hour;
+		outComponents.day[i] = components.day;
+		outComponents.month[i] = components.month;
+		outComponents.year[i] = components.year;
+	}
+}
+
+/****************************** InstructionSet ********************************/
+const char* UnixTimeBatch::InstructionSet(void)
+{
+#ifndef UNIX_TIME_BATCH_SIMD
+	return("scalar");
+#elif defined __AVX2__
+	return("AVX2");
+#else
+	return("SSE2");
+#endif
+}
@@ -0,0 +1,92 @@
+/*
+*	UnixTimeConverter.cpp, Copyright Jonathan Mackey 2026
+*
+*	Conversions between Unix time and date/time components, generic over the
+*	type used to hold the time.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "UnixTimeConverter.h"
+#include "CivilCalendar.h"
+
+/******************************* TimeComponents *******************************/
+template <class TTime>
+void UnixTimeConverter<TTime>::TimeComponents(
+	TTime		inTime,
+	uint8_t&	outHour,
+	uint8_t&	outMinute,
+	uint8_t&	outSecond)
+{
+	/*
+	*	Only the seconds of the day are needed.  Working with a uint32_t after
+	*	removing the days keeps the remaining divisions 32 bit for time64_t.
+	*/
+	uint32_t	time = (uint32_t)(inTime - (Days(inTime) * 86400));
+	outSecond = time % 60;
+	time /= 60;
+	outMinute = time % 60;
+	time /= 60;
+	outHour = time % 24;
+}
+
+/******************************* DateComponents *******************************/
+template <class TTime>
+TTime UnixTimeConverter<TTime>::DateComponents(
+	TTime		inTime,
+	uint16_t&	outYear,
+	uint8_t&	outMonth,
+	uint8_t&	outDay)
+{
+	TTime	days = Days(inTime);
+	CivilCalendar::CivilFromDays((uint32_t)(days + CivilCalendar::kUnixEpochDays),
+									outYear, outMonth, outDay);
+	return(inTime - (days * 86400));
+}
+
+/******************************** ToComponents ********************************/
+template <class TTime>
+void UnixTimeConverter<TTime>::ToComponents(
+	TTime			inTime,
+	SComponents&	outComponents)
+{
+	TimeComponents(DateComponents(inTime,
+									outComponents.year,
+									outComponents.month,
+									outComponents.day),
+									outComponents.hour,
+									outComponents.minute,
+									outComponents.second);
+}
+
+/******************************* FromComponents *******************************/
+template <class TTime>
+TTime UnixTimeConverter<TTime>::FromComponents(
+	const SComponents&	inComponents)
+{
+	TTime	time = ((TTime)CivilCalendar::DaysFromCivil(inComponents.year,
+						inComponents.month, inComponents.day) -
+							(TTime)CivilCalendar::kUnixEpochDays) * 86400;
+	time += (((uint32_t)inComponents.hour) * 3600);
+	time += (inComponents.minute * 60);
+	time += inComponents.second;
+	return(time);
+}
+
+template class UnixTimeConverter<time32_t>;
+template class UnixTimeConverter<time64_t>;
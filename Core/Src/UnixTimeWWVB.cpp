@@ -26,17 +26,45 @@
 *
 */
 #include "UnixTimeWWVB.h"
+#include "CivilCalendar.h"
+#include "LeapSeconds.h"
+#include "DUT1Schedule.h"
+#include "WWVBFrameEncoder.h"
+#include "WWVBPMScheduler.h"
+#include "TimeCodeStation.h"
 //#ifdef STM32_CUBE_	// Note this NOT a standard preprocessor macro.
 
-static volatile uint32_t	sDuration;
+static volatile uint32_t	sPattern;		// Tenths the carrier is reduced
+static volatile uint32_t	sLowOutput;		// CCR1 of the reduced carrier
 static volatile uint32_t	sTenthsCount;
 static volatile uint32_t	sTimeCodeBitCount;
 static volatile uint32_t	sTimeToNextGPSUpdate;
-static SWWVBTimeCode		sWWVBTimeCode;
+#ifdef STM32_CUBE_
+static SWWVBPackedFrame		sWWVBFrames[2];
+static SWWVBPMFrame			sPMFrames[2];
+#endif
+static volatile uint32_t	sFrameIndex;	// Of the frames being sent
+static volatile time32_t	sNextFrameTime;	// Minute of the idle frame, 0 = none
+static volatile bool		sJoinPending;	// Rebuild the frame mid-minute
+static WWVBFrameEncoder		sFrameEncoder;
+static WWVBPMScheduler		sPMScheduler;
+#ifdef STM32_CUBE_
+static int16_t				sGPSLatency = 300;	// ms, see SetGPSLatency()
+static volatile bool		sDUT1Pending;	// An entry from the UART to add
+static time32_t				sPendingDUT1Time;
+static int8_t				sPendingDUT1;
+#endif
 static uint8_t				sByteReceived;
 static char					sNMEAStrBuf[128];
 static char					sNMEAHexStrBuf[15];
 static volatile uint32_t	sNMEAStrIdx;
+#ifdef STM32_CUBE_
+static SWWVBTableValues		sTableValues[2];	// Written only by the main loop
+static volatile uint32_t	sTableValuesIndex;	// Of the values the RTC ISR uses
+static volatile bool		sRemoveLeapSecondsPending;	// GPS set the time
+static volatile int8_t		sPendingLeapSecond;	// From the UART to simulate, 0 = none
+#endif
+DSTBitCache					UnixTimeWWVB::sDSTCache;
 #define HIGH_OUTPUT		66
 #define LOW_OUTPUT		0
 
@@ -53,6 +81,38 @@ UART_HandleTypeDef* UnixTimeWWVB::sUART2Hndl;
 */
 #define DEBUG_WWVB_TIMING	1
 
+/*
+*	Set WWVB_PHASE_MODULATION to 1 to also send the phase modulated time code
+*	by inverting the TIM3 channel 1 output polarity for each 1 phase bit.
+*	Because HIGH_OUTPUT is half of the period, inverting the polarity shifts
+*	the carrier by 180 degrees.
+*
+*	Set WWVB_PHASE_MODULATION to 0 to only send the amplitude modulated code.
+*/
+#define WWVB_PHASE_MODULATION	1
+
+/*
+*	Set WWVB_BUILD_FRAME_IN_ISR to 1 to always build the frame in the RTC ISR
+*	rather than using the frame prepared by PrepareNextFrame().  This is only
+*	useful for comparing the ISR timing (see WWVB_ISR_TIMING.)
+*/
+#define WWVB_BUILD_FRAME_IN_ISR	0
+
+/*
+*	Set WWVB_MID_MINUTE_JOIN to 1 to start sending the current minute's frame
+*	at the current second when the time is set (see JoinMidMinute().)  A
+*	frame's content is fixed for the whole minute, so receivers can start
+*	accumulating valid symbols immediately rather than up to a minute later.
+*
+*	Set WWVB_MID_MINUTE_JOIN to 0 to keep sending the old frame until the
+*	minute ends.
+*/
+#define WWVB_MID_MINUTE_JOIN	1
+
+#if WWVB_ISR_TIMING
+static UnixTimeWWVB::SISRTiming	sISRTiming;
+#endif
+
 /********************************** InitWWVB **********************************/
 void UnixTimeWWVB::InitWWVB(
 	RTC_HandleTypeDef*	inRTCHndl,
@@ -79,15 +139,27 @@ void UnixTimeWWVB::InitWWVB(
 	*/
 	TIM3->CCR1 = LOW_OUTPUT;
 
-	sDuration = 2;
+	sPattern = TimeCodeStation::kWWVB.patterns[0];
+	sLowOutput = LOW_OUTPUT;
 	sTenthsCount = 0;
+	UnixTime::SetSubsecondSource(&sTenthsCount, 10);
 	sNMEAStrIdx = 0;
 	UnixTime::SetTime(0x6423FFF0);	// 0x6423FFF0 = 29-MAR-2023 09:08:00
-	UnixTimeWWVB::LoadTimeCodeStruct(0x6423FFF0, sWWVBTimeCode);	// initialize with dummy time
-	sTimeCodeBitCount = sizeof(SWWVBTimeCode)-1;	// Force a new frame to be generated.
+	PublishTableValues(0x6423FFF0);
+	UnixTimeWWVB::LoadPackedFrame(0x6423FFF0, sWWVBFrames[0]);	// initialize with dummy time
+	UnixTimeWWVB::LoadPMFrame(0x6423FFF0, sPMFrames[0]);
+	sFrameIndex = 0;
+	sNextFrameTime = 0;
+	sTimeCodeBitCount = 0;
 
 	WakeUpGPSModule();
 
+#if WWVB_ISR_TIMING
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
 	/*
 	*	Start calling both TIM2 & TIM3 interrupt callbacks.
 	*/
@@ -148,12 +220,11 @@ void UnixTimeWWVB::PutGPSModuleToSleep(void)
 	HAL_GPIO_WritePin(GPIOB, GPIO_PIN_10, GPIO_PIN_RESET);
 	{
 		time32_t	time = Time();
-		uint8_t	hour, minute, second;
-		TimeComponents(time, hour, minute, second);
+		const SComponents&	components = CurrentComponents();
 		// Truncate the time to remove minutes and seconds.
-		time -= ((minute * 60) + second);
+		time -= ((components.minute * 60) + components.second);
 		// Set the time to the next half hour
-		time += (minute >= 30 ? (90*60):(30*60));
+		time += (components.minute >= 30 ? (90*60):(30*60));
 		sTimeToNextGPSUpdate = time;
 		//	UInt32ToHexStr(time, sNMEAHexStrBuf);
 		//	sNMEAHexStrBuf[8] = '\n';
@@ -161,6 +232,210 @@ void UnixTimeWWVB::PutGPSModuleToSleep(void)
 	}
 	HAL_UART_AbortReceive(sUART2Hndl);
 }
+
+/****************************** PrepareNextFrame ******************************/
+/*
+*	The RTC ISR only swaps to the idle frame when sNextFrameTime matches the
+*	minute just started, and sNextFrameTime is zeroed while the idle frame is
+*	being built, so the ISR never uses a partially built frame.  If the frame
+*	isn't ready in time, such as right after the time is set, the ISR builds
+*	the frame itself as it did before (a PM time frame without the notice
+*	bit and dst_next, even in an extended message minute.)
+*/
+void UnixTimeWWVB::PrepareNextFrame(void)
+{
+	bool		tablesChanged = false;
+	/*
+	*	DUT1 entries received by the UART ISR are added here so that the
+	*	schedule is never modified while a frame is being built, and the RTC
+	*	ISR never reads the schedule.
+	*/
+	if (sDUT1Pending)
+	{
+		DUT1Schedule::AddEntry(sPendingDUT1Time, sPendingDUT1);
+		sDUT1Pending = false;
+		tablesChanged = true;
+	}
+	/*
+	*	Leap seconds added by SimulateLeapSecond() are removed once the GPS
+	*	sets the time.  The UART ISR only requests it so that the leap second
+	*	table is only ever touched from here.
+	*/
+	if (sRemoveLeapSecondsPending)
+	{
+		sRemoveLeapSecondsPending = false;
+		LeapSeconds::RemoveAddedLeapSeconds();
+		tablesChanged = true;
+	}
+	/*
+	*	A $PLEAP leap second request received by the UART ISR.  This sets
+	*	the time, so it's handled before the next minute is determined.
+	*/
+	if (sPendingLeapSecond)
+	{
+		SimulateLeapSecond(sPendingLeapSecond);
+		sPendingLeapSecond = 0;
+		tablesChanged = true;
+	}
+	time32_t	time = Snapshot().seconds;
+	time32_t	nextMinute = time - (time % 60) + 60;
+	/*
+	*	The values are kept for the next minute so that they're ready when
+	*	the ISR builds the first frame of a UTC day or after a DUT1 change.
+	*/
+	const SWWVBTableValues&	values = sTableValues[sTableValuesIndex];
+	if (tablesChanged ||
+		nextMinute < values.start ||
+		nextMinute >= values.end)
+	{
+		PublishTableValues(nextMinute);
+	}
+	if (tablesChanged)
+	{
+		sNextFrameTime = 0;
+		sFrameEncoder.Invalidate();
+	}
+	if (sNextFrameTime != nextMinute)
+	{
+		sNextFrameTime = 0;
+		__DMB();
+		uint32_t	idleIndex = sFrameIndex ^ 1;
+		sWWVBFrames[idleIndex] = sFrameEncoder.Encode(nextMinute);
+		sPMScheduler.LoadFrame(nextMinute, sPMFrames[idleIndex]);
+		__DMB();
+		sNextFrameTime = nextMinute;
+		/*
+		*	If the next minute ends with a leap second THEN
+		*	have the clock insert or skip it.
+		*/
+		time32_t	leapSecondTime;
+		int8_t		delta;
+		if (LeapSeconds::NextLeapSecond(nextMinute, leapSecondTime, delta) &&
+			leapSecondTime == (nextMinute + 60))
+		{
+			Clock().ScheduleLeapSecond(leapSecondTime, delta);
+		}
+	}
+}
+
+/***************************** PublishTableValues *****************************/
+/*
+*	Loads the values into the copy the RTC ISR isn't using, then switches
+*	the ISR to it, so the ISR never sees partially loaded values.
+*/
+void UnixTimeWWVB::PublishTableValues(
+	time32_t	inTime)
+{
+	uint32_t	idleIndex = sTableValuesIndex ^ 1;
+	LoadTableValues(inTime, sTableValues[idleIndex]);
+	__DMB();
+	sTableValuesIndex = idleIndex;
+}
+
+/******************************* SetGPSLatency ********************************/
+void UnixTimeWWVB::SetGPSLatency(
+	int16_t	inMilliseconds)
+{
+	sGPSLatency = inMilliseconds;
+}
+
+/***************************** CompensateLatency ******************************/
+/*
+*	inTime is the time in an RMC sentence just received.  The sentence
+*	arrives sGPSLatency ms after inTime began, and sTenthsCount tenths have
+*	elapsed since the last RTC second.  Returns the time to set so the RTC
+*	seconds are the nearest whole seconds to UTC.  The RTC phase itself
+*	isn't adjusted, so the edges remain within half a second of UTC.
+*/
+time32_t UnixTimeWWVB::CompensateLatency(
+	time32_t	inTime)
+{
+	int32_t	sinceLastTick = (int32_t)sGPSLatency - (int32_t)(sTenthsCount * 100);
+	// Round to the nearest second (floor division of a possibly negative value)
+	int32_t	adjustment = (sinceLastTick + 500 + 10000)/1000 - 10;
+	return(inTime + adjustment);
+}
+
+/***************************** SimulateLeapSecond *****************************/
+/*
+*	Adds a leap second at the end of the current month and sets the time to
+*	two minutes before it.  The GPS module is put to sleep so that it doesn't
+*	correct the time until after the leap second.  When the GPS next sets the
+*	time the added leap second is removed.
+*/
+bool UnixTimeWWVB::SimulateLeapSecond(
+	int8_t	inDelta)
+{
+	uint16_t	year;
+	uint8_t		month, day;
+	DateComponents(Time(), year, month, day);
+	if (++month > 12)
+	{
+		month = 1;
+		year++;
+	}
+	time32_t	monthEnd = (CivilCalendar::DaysFromCivil(year, month, 1) -
+							CivilCalendar::kUnixEpochDays) * kOneDay;
+	bool	added = LeapSeconds::AddLeapSecond(monthEnd, inDelta);
+	if (added)
+	{
+		// The ISR joins mid-minute using the values, so update them first.
+		PublishTableValues(monthEnd - 120);
+		__disable_irq();
+		SetTime(monthEnd - 120);
+		JoinMidMinute();
+		__enable_irq();
+		PutGPSModuleToSleep();
+	}
+	return(added);
+}
+
+/******************************* JoinMidMinute ********************************/
+void UnixTimeWWVB::JoinMidMinute(void)
+{
+	sJoinPending = WWVB_MID_MINUTE_JOIN;
+}
+
+/****************************** SetTimeZoneRule *******************************/
+/*
+*	The next minute's frame may already have been built with the old rule,
+*	so it's discarded along with the encoder's and scheduler's state.
+*/
+void UnixTimeWWVB::SetTimeZoneRule(
+	TimeZoneRule*	inRule)
+{
+	sDSTCache.SetTimeZoneRule(inRule);
+	time32_t	time = Snapshot().seconds;
+	PublishTableValues(time - (time % 60) + 60);
+	sPMScheduler.Invalidate();
+	sFrameEncoder.Invalidate();
+	sNextFrameTime = 0;
+}
+
+/******************************** PMScheduler *********************************/
+WWVBPMScheduler& UnixTimeWWVB::PMScheduler(void)
+{
+	return(sPMScheduler);
+}
+
+#if WWVB_ISR_TIMING
+/********************************* ISRTiming **********************************/
+const UnixTimeWWVB::SISRTiming& UnixTimeWWVB::ISRTiming(void)
+{
+	return(sISRTiming);
+}
+
+/****************************** ReportISRTiming *******************************/
+void UnixTimeWWVB::ReportISRTiming(void)
+{
+	static char	sTimingStrBuf[20];
+	UInt32ToHexStr(sISRTiming.max, sTimingStrBuf);
+	sTimingStrBuf[8] = ' ';
+	UInt32ToHexStr(sISRTiming.minuteMax, &sTimingStrBuf[9]);
+	sTimingStrBuf[17] = '\n';
+	HAL_UART_Transmit_IT(sUART2Hndl, (uint8_t*)sTimingStrBuf, 18);
+}
+#endif
 #endif
 
 #define CHECK_RMC_STATUS 0
@@ -352,107 +627,35 @@ void UnixTimeWWVB::LoadTimeCodeStruct(
 	time32_t		inTime,
 	SWWVBTimeCode&	outTCS)
 {
-	uint8_t	hour, minute, second, month, day;
-	uint16_t	year;
-	TimeComponents(DateComponents(inTime, year, month, day), hour, minute, second);
-	bool		isLY = (year%4) == 0;
-	uint16_t	dayOfYear = (isLY ? kDaysToLY : kDaysTo)[month-1] + day;
-	
-	// Date
-	ToTimeCode8421(minute, nullptr, outTCS.minutes10, outTCS.minutes1);
-	ToTimeCode8421(hour, nullptr, outTCS.hours10, outTCS.hours1);
-	ToTimeCode8421(dayOfYear, outTCS.dayOfYear100, outTCS.dayOfYear10, outTCS.dayOfYear1);
-	ToTimeCode8421(year%100, nullptr, outTCS.year10, outTCS.year1);
-	// DUT, subtract 0.3s to account for latency (0.3s is just a guess)
-	To8421(eDUT_Negative, outTCS.dutSign);
-	To8421(3, outTCS.dutValue);
-	
-	/*
-	*	Initialize the daylight savings time bits based on the month, day and
-	*	day of week.
-	*/
-	{
-		uint8_t	dstStatus = eDST_NotInEffect;	// i.e. Standard time
-		switch (month)
-		{
-			//case 1:
-			//case 2:
-			//case 11:
-			//case 12:
-			//	break;
-			case 3:
-			{
-				// DST begins on the 2nd Sunday in March at 2AM
-				uint8_t	dow = DayOfWeek(inTime);	// 0 = Sun, 6 = Sat
-				// S M T W T F S
-				// 0 1 2 3 4 5 6
-				uint8_t	elaspsedSundays = (day + 6 - dow)/7;
-				/*
-				*	If dow is Sunday AND
-				*	this is the 2nd Sunday of the month THEN
-				*	DST begins today.
-				*/
-				if (dow == 0 && elaspsedSundays == 2)
-				{
-					/*
-					*	According to the NIST, on the day DST begins, only bit
-					*	57 is set (eDST_BeginsToday)
-					*/
-					dstStatus = eDST_BeginsToday;
-				/*
-				*	If the 2nd Sunday in March has passed THEN
-				*	DST is in effect.
-				*/
-				} else if (elaspsedSundays >= 2)
-				{
-					dstStatus = eDST_InEffect;
-				}
-				break;
-			}
-			case 4:
-			case 5:
-			case 6:
-			case 7:
-			case 8:
-			case 9:
-			case 10:
-				dstStatus = eDST_InEffect;
-				break;
-			case 11:
-			{
-				// DST ends on the first Sunday in November at 2AM
-				uint8_t	dow = DayOfWeek(inTime);	// 0 = Sun, 6 = Sat
-				uint8_t	elaspsedSundays = (day + 6 - dow)/7;
-				/*
-				*	If dow is Sunday AND
-				*	this is the 1st Sunday of the month THEN
-				*	DST ends today.
-				*/
-				if (dow == 0 && elaspsedSundays == 1)
-				{
-					/*
-					*	According to the NIST, on the day DST ends, only bit 58
-					*	is set (eDST_EndsToday)
-					*/
-					dstStatus = eDST_EndsToday;
-				/*
-				*	If the 1st Sunday in November hasn't passed THEN
-				*	DST is in effect.
-				*/
-				} else if (elaspsedSundays < 1)
-				{
-					dstStatus = eDST_InEffect;
-				}
-				break;
-			}
-			
-		}
-		outTCS.dstStatus[0] = dstStatus >> 1;
-		outTCS.dstStatus[1] = dstStatus & 1;
-	}
+	SComponents	components;
+	SWWVBTableValues	values;
+	ToComponents(inTime, components);
+	LoadTableValues(inTime, values);
+	LoadTimeCodeStruct(components,
+		CivilCalendar::DayOfYear(components.year, components.month, components.day),
+		values, outTCS);
+}
 
- 	outTCS.leapYearIndicator = isLY;
-	outTCS.leapSecondAtEOM = 0;
+/***************************** LoadTimeCodeStruct *****************************/
+void UnixTimeWWVB::LoadTimeCodeStruct(
+	const SComponents&		inComponents,
+	uint16_t				inDayOfYear,
+	const SWWVBTableValues&	inValues,
+	SWWVBTimeCode&			outTCS)
+{
+	SWWVBFrameFields	fields;
+	LoadFrameFields(inComponents, inDayOfYear, inValues, fields);
+	
+	ToTimeCode8421(fields.minute, nullptr, outTCS.minutes10, outTCS.minutes1);
+	ToTimeCode8421(fields.hour, nullptr, outTCS.hours10, outTCS.hours1);
+	ToTimeCode8421(fields.dayOfYear, outTCS.dayOfYear100, outTCS.dayOfYear10, outTCS.dayOfYear1);
+	ToTimeCode8421(fields.year, nullptr, outTCS.year10, outTCS.year1);
+	To8421(fields.dutSign, outTCS.dutSign);
+	To8421(fields.dutValue, outTCS.dutValue);
+	outTCS.dstStatus[0] = fields.dstStatus >> 1;
+	outTCS.dstStatus[1] = fields.dstStatus & 1;
+ 	outTCS.leapYearIndicator = fields.leapYearIndicator;
+	outTCS.leapSecondAtEOM = fields.leapSecondAtEOM;
 
 	// Set the markers
 	outTCS.minutes10[0] = outTCS.p1 = outTCS.p2 = outTCS.p3 = outTCS.p4 = outTCS.p5 = outTCS.p0 = 2;
@@ -461,6 +664,206 @@ void UnixTimeWWVB::LoadTimeCodeStruct(
 	outTCS.z0 = outTCS.z1 = outTCS.z2 = outTCS.z3 = outTCS.z4 = outTCS.z5 = 0;
 }
 
+/****************************** LoadPackedFrame *******************************/
+void UnixTimeWWVB::LoadPackedFrame(
+	time32_t			inTime,
+	SWWVBPackedFrame&	outFrame)
+{
+	SComponents	components;
+	SWWVBTableValues	values;
+	ToComponents(inTime, components);
+	LoadTableValues(inTime, values);
+	LoadPackedFrame(components,
+		CivilCalendar::DayOfYear(components.year, components.month, components.day),
+		values, outFrame);
+}
+
+/****************************** LoadPackedFrame *******************************/
+/*
+*	The digit offsets are the same as the SWWVBTimeCode field offsets.
+*/
+void UnixTimeWWVB::LoadPackedFrame(
+	const SComponents&		inComponents,
+	uint16_t				inDayOfYear,
+	const SWWVBTableValues&	inValues,
+	SWWVBPackedFrame&		outFrame)
+{
+	// Seconds 0, 9, 19, 29, 39, 49 and 59
+	const uint64_t	kMarkers = 0x0802008020080201ULL;
+	SWWVBFrameFields	fields;
+	LoadFrameFields(inComponents, inDayOfYear, inValues, fields);
+	
+	uint8_t		minute = fields.minute;
+	uint8_t		hour = fields.hour;
+	uint16_t	dayOfYear = fields.dayOfYear;
+	uint8_t		year = fields.year;
+	uint64_t	data =
+		SWWVBPackedFrame::DigitAt(minute/10, 0) |
+		SWWVBPackedFrame::DigitAt(minute%10, 5) |
+		SWWVBPackedFrame::DigitAt(hour/10, 10) |
+		SWWVBPackedFrame::DigitAt(hour%10, 15) |
+		SWWVBPackedFrame::DigitAt(dayOfYear/100, 20) |
+		SWWVBPackedFrame::DigitAt((dayOfYear/10)%10, 25) |
+		SWWVBPackedFrame::DigitAt(dayOfYear%10, 30) |
+		SWWVBPackedFrame::DigitAt(fields.dutSign, 35) |
+		SWWVBPackedFrame::DigitAt(fields.dutValue, 40) |
+		SWWVBPackedFrame::DigitAt(year/10, 45) |
+		SWWVBPackedFrame::DigitAt(year%10, 50) |
+		((uint64_t)fields.leapYearIndicator << 55) |
+		((uint64_t)fields.leapSecondAtEOM << 56) |
+		((uint64_t)(fields.dstStatus >> 1) << 57) |
+		((uint64_t)(fields.dstStatus & 1) << 58);
+	outFrame.data = data & ~kMarkers;
+	outFrame.marker = kMarkers;
+}
+
+/*
+*	Phase modulation frame constants, see the NIST description of the
+*	enhanced WWVB broadcast format.
+*
+*	The 13 bit timing sync word sent in seconds 0 to 12.
+*/
+const uint32_t	kPMSyncT = 0x768;
+/*
+*	The (31,26) Hamming code parity masks over the 26 bit minute of century.
+*	par[n] is the parity of the minute bits in kPMTimeParity[n].
+*/
+const uint32_t	kPMTimeParity[] = {0x0B3E375, 0x167C6EA, 0x2CF8DD4, 0x12CF8DD, 0x259F1BA};
+/*
+*	The 5 bit dst_ls codes indexed by the leap second (none, negative,
+*	positive) and the eDST status.
+*/
+const uint8_t	kPMDSTLeapSecond[3][4] =
+{
+	{0x08, 0x15, 0x16, 0x03},	// No leap second
+	{0x04, 0x0E, 0x13, 0x0D},	// Negative leap second at EOM
+	{0x19, 0x1A, 0x1C, 0x1F}	// Positive leap second at EOM
+};
+
+/********************************** MSBFirst **********************************/
+/*
+*	Returns the inWidth bits of inValue placed most significant bit first
+*	starting at inFirstSecond.
+*/
+static uint64_t MSBFirst(
+	uint32_t	inValue,
+	uint32_t	inWidth,
+	uint32_t	inFirstSecond)
+{
+	uint64_t	bits = 0;
+	for (uint32_t i = 0; i < inWidth; i++)
+	{
+		bits |= (uint64_t)((inValue >> (inWidth - 1 - i)) & 1) << (inFirstSecond + i);
+	}
+	return(bits);
+}
+
+/******************************** LoadPMFrame *********************************/
+void UnixTimeWWVB::LoadPMFrame(
+	time32_t		inTime,
+	SWWVBPMFrame&	outFrame)
+{
+	SWWVBTableValues	values;
+	LoadTableValues(inTime, values);
+	LoadPMFrame(inTime, values, outFrame);
+}
+
+/******************************** LoadPMFrame *********************************/
+/*
+*	Seconds		Field
+*	 0 - 12		sync_T
+*	13 - 17		par[4:0]
+*	18			time[25]
+*	19			time[0]
+*	20 - 28		time[24:16]
+*	29			Reserved
+*	30 - 38		time[15:7]
+*	39			Reserved
+*	40 - 45		time[6:1]
+*	46 - 47		dst_ls[4:3]
+*	48			Notice (see WWVBPMScheduler)
+*	49			Reserved
+*	50 - 52		dst_ls[2:0]
+*	53 - 58		dst_next[5:0] (see WWVBPMScheduler)
+*	59			Reserved
+*/
+void UnixTimeWWVB::LoadPMFrame(
+	time32_t				inTime,
+	const SWWVBTableValues&	inValues,
+	SWWVBPMFrame&			outFrame)
+{
+	uint32_t	minute = MinuteOfCentury(inTime);
+	uint32_t	parity = 0;
+	for (uint32_t i = 0; i < 5; i++)
+	{
+		parity |= (uint32_t)__builtin_parity(minute & kPMTimeParity[i]) << i;
+	}
+	int8_t		leapSecond = inValues.leapSecondAtEOM;
+	uint8_t		dstLeapSecond = kPMDSTLeapSecond[leapSecond ? (leapSecond < 0 ? 1 : 2) : 0]
+						[inValues.dstStatus];
+	outFrame.phase =
+		MSBFirst(kPMSyncT, 13, 0) |
+		MSBFirst(parity, 5, 13) |
+		MSBFirst(minute >> 25, 1, 18) |
+		MSBFirst(minute, 1, 19) |
+		MSBFirst(minute >> 16, 9, 20) |
+		MSBFirst(minute >> 7, 9, 30) |
+		MSBFirst(minute >> 1, 6, 40) |
+		MSBFirst(dstLeapSecond >> 3, 2, 46) |
+		MSBFirst(dstLeapSecond, 3, 50);
+}
+
+/****************************** LoadFrameFields *******************************/
+void UnixTimeWWVB::LoadFrameFields(
+	const SComponents&		inComponents,
+	uint16_t				inDayOfYear,
+	const SWWVBTableValues&	inValues,
+	SWWVBFrameFields&		outFields)
+{
+	outFields.minute = inComponents.minute;
+	outFields.hour = inComponents.hour;
+	outFields.dayOfYear = inDayOfYear;
+	outFields.year = inComponents.year%100;
+	int8_t		dut1 = inValues.dut1;
+	outFields.dutSign = dut1 < 0 ? eDUT_Negative : eDUT_Positive;
+	outFields.dutValue = dut1 < 0 ? -dut1 : dut1;
+	outFields.dstStatus = inValues.dstStatus;
+	outFields.leapYearIndicator = CivilCalendar::IsLeapYear(inComponents.year);
+	/*
+	*	Set from the start of the month containing a leap second until the
+	*	leap second occurs.
+	*/
+	outFields.leapSecondAtEOM = inValues.leapSecondAtEOM != 0;
+}
+
+/****************************** LoadTableValues *******************************/
+void UnixTimeWWVB::LoadTableValues(
+	time32_t			inTime,
+	SWWVBTableValues&	outValues)
+{
+	uint16_t	year;
+	uint8_t		month, day;
+	DateComponents(inTime, year, month, day);
+	/*
+	*	The DST status changes at most daily and the leap second warning
+	*	monthly, so the values hold for the rest of the UTC day.
+	*/
+	outValues.start = inTime - inTime % kOneDay;
+	outValues.end = outValues.start + kOneDay;
+	outValues.dstStatus = DSTStatus(year, CivilCalendar::DayOfYear(year, month, day));
+	outValues.leapSecondAtEOM = LeapSeconds::LeapSecondAtEOM(inTime);
+	time32_t	dut1Start, dut1End;
+	outValues.dut1 = DUT1Schedule::DUT1(inTime, dut1Start, dut1End);
+	if (dut1Start > outValues.start)
+	{
+		outValues.start = dut1Start;
+	}
+	if (dut1End < outValues.end)
+	{
+		outValues.end = dut1End;
+	}
+}
+
 /*********************************** To8421 ***********************************/
 void UnixTimeWWVB::To8421(
 	uint8_t		inValue,
@@ -500,12 +903,23 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 	/* Prevent unused argument(s) compilation warning */
 	UNUSED(htim);
 
-	if (sDuration == sTenthsCount)
+	/*
+	*	The carrier is reduced during the tenths set in the second's pattern
+	*	(see TimeCodeStation.)  For WWVB the reduced tenths come first, for
+	*	stations like JJY they come last.
+	*/
+	if (sTenthsCount < 10)
 	{
-		TIM3->CCR1 = HIGH_OUTPUT;	// 50% duty (symmetrical square wave)
+		if ((sPattern >> sTenthsCount) & 1)
+		{
+			TIM3->CCR1 = sLowOutput;
+		} else
+		{
+			TIM3->CCR1 = HIGH_OUTPUT;	// 50% duty (symmetrical square wave)
 #if DEBUG_WWVB_TIMING
-		HAL_GPIO_WritePin(GPIOB, GPIO_PIN_0, GPIO_PIN_SET);
+			HAL_GPIO_WritePin(GPIOB, GPIO_PIN_0, GPIO_PIN_SET);
 #endif
+		}
 	}
 	sTenthsCount++;
 #if DEBUG_WWVB_TIMING
@@ -524,34 +938,71 @@ void HAL_RTCEx_RTCEventCallback(RTC_HandleTypeDef *hrtc)
 {
 	/* Prevent unused argument(s) compilation warning */
 	UNUSED(hrtc);
+#if WWVB_ISR_TIMING
+	uint32_t	startCycles = DWT->CYCCNT;
+	bool		minuteStart = false;
+#endif
 
 	UnixTime::Tick();
-		
-	if (sTimeCodeBitCount < 59)
-	{
-		sTimeCodeBitCount++;
-	} else
+	
+	/*
+	*	The symbol sent is the clock's second, so the minute ending with a
+	*	positive leap second has 61 symbols (the extra second, 60, is a 0 bit)
+	*	and the minute ending with a negative leap second has 59.
+	*/
+	sTimeCodeBitCount = UnixTime::CurrentComponents().second;
+	if (sTimeCodeBitCount == 0 ||
+		sJoinPending)
 	{
 		time32_t	thisTime = UnixTime::Time();
 		/*
 		*	Because WWVB time code frames don't include seconds, the frame
-		*	always starts on an even minute.
-		*
-		*	If on even minute (no seconds) THEN
-		*	Generate a new WWVB time code frame
+		*	always starts on an even minute.  After the time is set the frame
+		*	is joined mid-minute, i.e. built for the minute the time is in
+		*	and sent from sTimeCodeBitCount on.
+		*/
+		sJoinPending = false;
+#if WWVB_ISR_TIMING
+		minuteStart = true;
+#endif
+#if !WWVB_BUILD_FRAME_IN_ISR
+		/*
+		*	If PrepareNextFrame() has this minute's frame ready THEN
+		*	swap to it.
 		*/
-		if (thisTime % 60 == 0)
+		if (sNextFrameTime == thisTime)
 		{
-			// Generate a new WWVB time code frame.
-			UnixTimeWWVB::LoadTimeCodeStruct(thisTime, sWWVBTimeCode);
-			sTimeCodeBitCount = 0;
-#if DEBUG_WWVB_TIMING
-			HAL_GPIO_WritePin(GPIOB, GPIO_PIN_1, GPIO_PIN_SET);
-//			UInt32ToHexStr(thisTime, sNMEAHexStrBuf);
-//			sNMEAHexStrBuf[8] = '\n';
-//			HAL_UART_Transmit_IT(UnixTimeWWVB::sUART2Hndl, (uint8_t*)sNMEAHexStrBuf, 9);
+			sFrameIndex ^= 1;
+			sNextFrameTime = 0;
+		} else
+#endif
+		{
+			/*
+			*	Generate a new WWVB time code frame.  The values are for the
+			*	next minute, so they're only stale right after the time is
+			*	set or when joining in the last minute of their span, in
+			*	which case this minute has no leap second warning and keeps
+			*	the previous DUT1 and DST status.
+			*/
+			SWWVBTableValues	values = sTableValues[sTableValuesIndex];
+			if (thisTime < values.start ||
+				thisTime >= values.end)
+			{
+				values.leapSecondAtEOM = 0;
+			}
+			UnixTimeWWVB::LoadPackedFrame(UnixTime::CurrentComponents(),
+				UnixTime::CurrentDayOfYear(), values, sWWVBFrames[sFrameIndex]);
+			UnixTimeWWVB::LoadPMFrame(thisTime, values, sPMFrames[sFrameIndex]);
+#if WWVB_ISR_TIMING
+			sISRTiming.fallbacks++;
 #endif
 		}
+#if DEBUG_WWVB_TIMING
+		HAL_GPIO_WritePin(GPIOB, GPIO_PIN_1, GPIO_PIN_SET);
+//		UInt32ToHexStr(thisTime, sNMEAHexStrBuf);
+//		sNMEAHexStrBuf[8] = '\n';
+//		HAL_UART_Transmit_IT(UnixTimeWWVB::sUART2Hndl, (uint8_t*)sNMEAHexStrBuf, 9);
+#endif
 		
 		/*
 		*	If it's time to update the time using the GPS module
@@ -562,13 +1013,28 @@ void HAL_RTCEx_RTCEventCallback(RTC_HandleTypeDef *hrtc)
 			UnixTimeWWVB::WakeUpGPSModule();
 		}
 	}
-	static const uint8_t	kBitDurations[] = {2,5,8};// 0.2s, 0.5s, 0.8s = 0, 1, M
-	sDuration = kBitDurations[sWWVBTimeCode.minutes10[sTimeCodeBitCount]];
+	// 0.2s, 0.5s, 0.8s reduced = 0, 1, M.  The descriptor is constexpr, so
+	// this is the same table lookup as a duration table.
+	sPattern = TimeCodeStation::kWWVB.Pattern(
+				sWWVBFrames[sFrameIndex].GetSymbol(sTimeCodeBitCount), sTimeCodeBitCount);
 	/*
 	*	All bits start at low output (in this case none) as specified in
 	*	the WWVB documentation.
 	*/
+#if WWVB_PHASE_MODULATION
+	/*
+	*	The phase changes at the start of the second, while the output is
+	*	low.  With the polarity inverted, low output is a CCR1 beyond ARR.
+	*/
+	{
+		uint32_t	phase = sPMFrames[sFrameIndex].GetPhase(sTimeCodeBitCount);
+		sLowOutput = phase ? (TIM3->ARR + 1) : LOW_OUTPUT;
+		TIM3->CCR1 = sLowOutput;
+		TIM3->CCER = (TIM3->CCER & ~TIM_CCER_CC1P) | (phase * TIM_CCER_CC1P);
+	}
+#else
 	TIM3->CCR1 = LOW_OUTPUT;
+#endif
 	
 #if DEBUG_WWVB_TIMING
 	HAL_GPIO_WritePin(GPIOB, GPIO_PIN_0, GPIO_PIN_RESET);
@@ -579,6 +1045,19 @@ void HAL_RTCEx_RTCEventCallback(RTC_HandleTypeDef *hrtc)
 	
 	// Sync TIM2 to the RTC
 	HAL_TIM_GenerateEvent(UnixTimeWWVB::sTim2Hndl, TIM_EGR_UG);
+#if WWVB_ISR_TIMING
+	uint32_t	cycles = DWT->CYCCNT - startCycles;
+	sISRTiming.last = cycles;
+	if (cycles > sISRTiming.max)
+	{
+		sISRTiming.max = cycles;
+	}
+	if (minuteStart &&
+		cycles > sISRTiming.minuteMax)
+	{
+		sISRTiming.minuteMax = cycles;
+	}
+#endif
 }
 
 /************************** HAL_UART_RxCpltCallback ***************************/
@@ -601,6 +1080,31 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 				sNMEAStrBuf[sNMEAStrIdx] = 0;	// Terminate string
 				sNMEAStrIdx = 0;				// Reset index
 				time32_t	timeRxd = UnixTimeWWVB::UnixTimeFromRMCString(sNMEAStrBuf);
+				time32_t	dut1Time;
+				int8_t		dut1;
+				/*
+				*	If the string is a $PDUT1 DUT1 schedule entry THEN
+				*	pass it to PrepareNextFrame() to add.
+				*/
+				if (!timeRxd &&
+					!sDUT1Pending &&
+					DUT1Schedule::ParseSentence(sNMEAStrBuf, dut1Time, dut1))
+				{
+					sPendingDUT1Time = dut1Time;
+					sPendingDUT1 = dut1;
+					sDUT1Pending = true;
+				}
+				/*
+				*	If the string is a $PLEAP request to simulate a leap
+				*	second THEN pass it to PrepareNextFrame().
+				*/
+				int8_t		leapSecond;
+				if (!timeRxd &&
+					!sPendingLeapSecond &&
+					LeapSeconds::ParseSentence(sNMEAStrBuf, leapSecond))
+				{
+					sPendingLeapSecond = leapSecond;
+				}
 				/*
 				*	The string received could be any NMEA string, but only RMC
 				*	strings containing a valid time and date are processed by
@@ -617,7 +1121,18 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 					*	for anything other than getting the second tick iterrupt, so
 					*	no reason to update the STM32 RTC_CNTH & RTC_CNTL (seconds.)
 					*/
-					UnixTime::SetTime(timeRxd);
+					time32_t	time = UnixTimeWWVB::CompensateLatency(timeRxd);
+					bool		changed = time != UnixTime::Time();
+					UnixTime::SetTime(time);
+					/*
+					*	Only join mid-minute when the time actually changed,
+					*	otherwise the frame being sent is already correct.
+					*/
+					if (changed)
+					{
+						UnixTimeWWVB::JoinMidMinute();
+					}
+					sRemoveLeapSecondsPending = true;
 					
 					// Turn on status LED to show that the time was successfully
 					// updated by the GPS.
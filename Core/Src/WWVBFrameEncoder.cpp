@@ -0,0 +1,135 @@
+/*
+*	WWVBFrameEncoder.cpp, Copyright Jonathan Mackey 2026
+*
+*	Incremental WWVB packed frame encoder.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "WWVBFrameEncoder.h"
+#include "CivilCalendar.h"
+#include "LeapSeconds.h"
+#include "DUT1Schedule.h"
+
+/*
+*	The data bits of each field, see SWWVBTimeCode for the offsets.
+*/
+const uint64_t	kMinuteBits = (0xFULL << 0) | (0xFULL << 5);
+const uint64_t	kHourBits = (0xFULL << 10) | (0xFULL << 15);
+const uint64_t	kDayOfYearBits = (0xFULL << 20) | (0xFULL << 25) | (0xFULL << 30);
+const uint64_t	kDUT1Bits = (0xFULL << 35) | (0xFULL << 40);
+const uint64_t	kYearBits = (0xFULL << 45) | (0xFULL << 50);
+const uint64_t	kDayLevelBits = 0xFULL << 55;	// Leap year, leap second, DST
+
+/****************************** WWVBFrameEncoder ******************************/
+WWVBFrameEncoder::WWVBFrameEncoder(void)
+	: mTime(0), mDUT1(0)
+{
+	mFrame.data = mFrame.marker = 0;
+}
+
+/*********************************** Encode ***********************************/
+const SWWVBPackedFrame& WWVBFrameEncoder::Encode(
+	time32_t	inTime)
+{
+	inTime -= (inTime % 60);
+	if (mTime &&
+		inTime == (mTime + 60))
+	{
+		NextMinute();
+	} else if (inTime != mTime)
+	{
+		Rebuild(inTime);
+	}
+	return(mFrame);
+}
+
+/********************************** Rebuild ***********************************/
+void WWVBFrameEncoder::Rebuild(
+	time32_t	inTime)
+{
+	mTime = inTime - (inTime % 60);
+	UnixTimeWWVB::ToComponents(mTime, mComponents);
+	mDayOfYear = CivilCalendar::DayOfYear(mComponents.year,
+											mComponents.month,
+											mComponents.day);
+	SWWVBTableValues	values;
+	UnixTimeWWVB::LoadTableValues(mTime, values);
+	UnixTimeWWVB::LoadPackedFrame(mComponents, mDayOfYear, values, mFrame);
+	mDUT1 = DUT1Schedule::DUT1(mTime);
+}
+
+/********************************* NextMinute *********************************/
+void WWVBFrameEncoder::NextMinute(void)
+{
+	uint64_t	data = mFrame.data;
+	mTime += 60;
+	if (++mComponents.minute < 60)
+	{
+		data &= ~kMinuteBits;
+		data |= SWWVBPackedFrame::DigitAt(mComponents.minute/10, 0) |
+				SWWVBPackedFrame::DigitAt(mComponents.minute%10, 5);
+	} else
+	{
+		// Minute 00
+		mComponents.minute = 0;
+		data &= ~kMinuteBits;
+		if (++mComponents.hour >= 24)
+		{
+			mComponents.hour = 0;
+			mDayOfYear++;
+			if (++mComponents.day >
+				CivilCalendar::DaysInMonth(mComponents.month, mComponents.year))
+			{
+				mComponents.day = 1;
+				if (++mComponents.month > 12)
+				{
+					mComponents.month = 1;
+					mComponents.year++;
+					mDayOfYear = 1;
+					uint8_t	year = mComponents.year % 100;
+					data &= ~kYearBits;
+					data |= SWWVBPackedFrame::DigitAt(year/10, 45) |
+							SWWVBPackedFrame::DigitAt(year%10, 50);
+				}
+			}
+			data &= ~(kDayOfYearBits | kDayLevelBits);
+			data |= SWWVBPackedFrame::DigitAt(mDayOfYear/100, 20) |
+					SWWVBPackedFrame::DigitAt((mDayOfYear/10)%10, 25) |
+					SWWVBPackedFrame::DigitAt(mDayOfYear%10, 30);
+			uint8_t	dstStatus = UnixTimeWWVB::DSTStatus(mComponents.year, mDayOfYear);
+			data |= ((uint64_t)CivilCalendar::IsLeapYear(mComponents.year) << 55) |
+					((uint64_t)(LeapSeconds::LeapSecondAtEOM(mTime) != 0) << 56) |
+					((uint64_t)(dstStatus >> 1) << 57) |
+					((uint64_t)(dstStatus & 1) << 58);
+		}
+		data &= ~kHourBits;
+		data |= SWWVBPackedFrame::DigitAt(mComponents.hour/10, 10) |
+				SWWVBPackedFrame::DigitAt(mComponents.hour%10, 15);
+	}
+	int8_t	dut1 = DUT1Schedule::DUT1(mTime);
+	if (dut1 != mDUT1)
+	{
+		mDUT1 = dut1;
+		data &= ~kDUT1Bits;
+		data |= SWWVBPackedFrame::DigitAt(dut1 < 0 ? UnixTimeWWVB::eDUT_Negative :
+												UnixTimeWWVB::eDUT_Positive, 35) |
+				SWWVBPackedFrame::DigitAt(dut1 < 0 ? -dut1 : dut1, 40);
+	}
+	mFrame.data = data & ~mFrame.marker;
+}
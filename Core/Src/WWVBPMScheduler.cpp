@@ -0,0 +1,222 @@
+/*
+*	WWVBPMScheduler.cpp, Copyright Jonathan Mackey 2026
+*
+*	Selects the WWVB phase modulation frame sent each minute.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "WWVBPMScheduler.h"
+
+/****************************** WWVBPMScheduler *******************************/
+WWVBPMScheduler::WWVBPMScheduler(void)
+	: mExtendedMessage(false), mDSTNext(false), mDSTNextDay(1), mDSTNextBits(0),
+	  mMessageStart(0), mBitIndex(0), mCRC(0)
+{
+}
+
+/********************************* Invalidate *********************************/
+void WWVBPMScheduler::Invalidate(void)
+{
+	mMessageStart = 0;	// Rebuild the message
+	mDSTNextDay = 1;
+}
+
+/***************************** SetExtendedMessage *****************************/
+void WWVBPMScheduler::SetExtendedMessage(
+	bool	inSend)
+{
+	mExtendedMessage = inSend;
+	mMessageStart = 0;
+}
+
+/********************************* SetDSTNext *********************************/
+void WWVBPMScheduler::SetDSTNext(
+	bool	inSend)
+{
+	mDSTNext = inSend;
+}
+
+/********************************* LoadFrame **********************************/
+void WWVBPMScheduler::LoadFrame(
+	time32_t		inTime,
+	SWWVBPMFrame&	outFrame)
+{
+	time32_t	minute = inTime - (inTime % 60);
+	if (mExtendedMessage &&
+		IsExtendedMinute(minute))
+	{
+		time32_t	windowStart = minute -
+						((((minute / 60) % 30) - kFirstExtendedMinute) * 60);
+		/*
+		*	The message is normally built the minute before.  If the time was
+		*	just set to within the window, build it now.
+		*/
+		if (mMessageStart != windowStart)
+		{
+			BuildMessage(windowStart);
+		}
+		outFrame = mFrames[(minute - windowStart) / 60];
+	} else
+	{
+		UnixTimeWWVB::LoadPMFrame(minute, outFrame);
+		if (mDSTNext)
+		{
+			outFrame.phase |= DSTNextBits(minute);
+		}
+		if (mExtendedMessage &&
+			IsExtendedMinute(minute + 60) &&
+			mMessageStart != (minute + 60))
+		{
+			BuildMessage(minute + 60);
+		}
+	}
+}
+
+/******************************** DSTNextBits *********************************/
+/*
+*	Returns the time frame's notice bit (second 48) and dst_next (seconds 53
+*	to 58, most significant bit first) for the UTC day containing inTime.
+*	NIST defines dst_next as a code for the DST rules in effect without
+*	publishing the codes, so when SetDSTNext() opts into it this sends the
+*	number of days from the start of the day to the rule's next DST
+*	transition instead, 63 when there's none within 62 days.  The notice bit is set when the transition is less
+*	than a week away.  Both only change daily, so they're cached.
+*/
+uint64_t WWVBPMScheduler::DSTNextBits(
+	time32_t	inTime)
+{
+	time32_t	day = inTime - (inTime % 86400);
+	if (day != mDSTNextDay)
+	{
+		uint32_t	days = 63;
+		if (UnixTimeWWVB::DSTCache().Rule().HasDST())
+		{
+			time32_t	transition;
+			for (uint32_t start = 0; start < 2; start++)
+			{
+				if (NextTransition(day, start, transition) &&
+					((transition - day) / 86400) < days)
+				{
+					days = (transition - day) / 86400;
+				}
+			}
+		}
+		mDSTNextBits = (uint64_t)(days < 7) << 48;
+		for (uint32_t bit = 0; bit < 6; bit++)
+		{
+			mDSTNextBits |= (uint64_t)((days >> (5 - bit)) & 1) << (53 + bit);
+		}
+		mDSTNextDay = day;
+	}
+	return(mDSTNextBits);
+}
+
+/******************************** BuildMessage ********************************/
+void WWVBPMScheduler::BuildMessage(
+	time32_t	inStart)
+{
+	TimeZoneRule&	rule = UnixTimeWWVB::DSTCache().Rule();
+	time32_t	dstStart = 0;
+	time32_t	dstEnd = 0;
+	if (rule.HasDST())
+	{
+		if (NextTransition(inStart, true, dstStart))
+		{
+			dstStart = UnixTimeWWVB::MinuteOfCentury(dstStart);
+		}
+		if (NextTransition(inStart, false, dstEnd))
+		{
+			dstEnd = UnixTimeWWVB::MinuteOfCentury(dstEnd);
+		}
+	}
+	mBitIndex = 0;
+	for (uint32_t i = 0; i < kExtendedMinutes; i++)
+	{
+		/*
+		*	sync_M, most significant bit first, in seconds 0 to 12.  Seconds
+		*	13 to 58 are filled by PutBits() and second 59 is reserved.
+		*/
+		uint64_t	phase = 0;
+		for (uint32_t bit = 0; bit < 13; bit++)
+		{
+			phase |= (uint64_t)((kSyncM >> (12 - bit)) & 1) << bit;
+		}
+		mFrames[i].phase = phase;
+	}
+	for (uint32_t copy = 0; copy < 3; copy++)
+	{
+		mCRC = 0xFFFF;
+		PutBits(kDSTScheduleMessage, 4);
+		PutBits(dstStart, 26);
+		PutBits(dstEnd, 26);
+		PutBits((uint32_t)(rule.StandardOffset() / 900), 8);
+		PutBits((uint32_t)(rule.DSTOffset() / 900), 8);
+		PutBits(mCRC, 16);
+	}
+	// The remaining 12 bits are zero.
+	mMessageStart = inStart;
+}
+
+/********************************** PutBits ***********************************/
+/*
+*	Appends the low inWidth bits of inValue, most significant bit first, to
+*	the message and to the CRC-16-CCITT (polynomial 0x1021) in mCRC.
+*/
+void WWVBPMScheduler::PutBits(
+	uint32_t	inValue,
+	uint32_t	inWidth)
+{
+	while (inWidth)
+	{
+		inWidth--;
+		uint32_t	bit = (inValue >> inWidth) & 1;
+		uint32_t	feedback = ((mCRC >> 15) & 1) ^ bit;
+		mCRC = (uint16_t)((mCRC << 1) ^ (feedback ? 0x1021 : 0));
+		mFrames[mBitIndex / kMessageBitsPerMinute].phase |=
+			(uint64_t)bit << (13 + (mBitIndex % kMessageBitsPerMinute));
+		mBitIndex++;
+	}
+}
+
+/******************************* NextTransition *******************************/
+/*
+*	Returns the first DST start (inStart true) or end at or after inTime.
+*/
+bool WWVBPMScheduler::NextTransition(
+	time32_t	inTime,
+	bool		inStart,
+	time32_t&	outTime)
+{
+	TimeZoneRule&	rule = UnixTimeWWVB::DSTCache().Rule();
+	uint16_t	year;
+	uint8_t		month, day;
+	UnixTimeConverter<time32_t>::DateComponents(inTime, year, month, day);
+	time64_t	start, end;
+	bool	hasDST = rule.Transitions(year, start, end);
+	if (hasDST &&
+		(inStart ? start : end) < inTime)
+	{
+		hasDST = rule.Transitions(year + 1, start, end);
+	}
+	if (hasDST)
+	{
+		outTime = (time32_t)(inStart ? start : end);
+	}
+	return(hasDST);
+}
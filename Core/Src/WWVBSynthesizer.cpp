@@ -0,0 +1,472 @@
+/*
+*	WWVBSynthesizer.cpp, Copyright Jonathan Mackey 2026
+*
+*	Synthesizes the time code signal as sampled data for host tools.
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "WWVBSynthesizer.h"
+#if defined __linux__ || defined __MACH__
+#include "TimeCodeEncoder.h"
+#include "DCF77PRN.h"
+#include <math.h>
+
+#if defined __AVX2__ || defined __SSE2__
+#include <immintrin.h>
+#define WWVB_SYNTHESIZER_SIMD	1
+#endif
+
+/************************************ GCD *************************************/
+static uint32_t GCD(
+	uint32_t	inA,
+	uint32_t	inB)
+{
+	while (inB)
+	{
+		uint32_t	remainder = inA % inB;
+		inA = inB;
+		inB = remainder;
+	}
+	return(inA);
+}
+
+/********************************* ScaleBlock *********************************/
+/*
+*	outBlock[i] = inTable[i] * inAmplitude
+*/
+static inline void ScaleBlock(
+	const float*	inTable,
+	float			inAmplitude,
+	float*			outBlock,
+	uint32_t		inCount)
+{
+	uint32_t	i = 0;
+#if defined __AVX2__
+	__m256	amplitude = _mm256_set1_ps(inAmplitude);
+	for (; (i + 8) <= inCount; i += 8)
+	{
+		_mm256_storeu_ps(&outBlock[i],
+			_mm256_mul_ps(_mm256_loadu_ps(&inTable[i]), amplitude));
+	}
+#elif defined __SSE2__
+	__m128	amplitude = _mm_set1_ps(inAmplitude);
+	for (; (i + 4) <= inCount; i += 4)
+	{
+		_mm_storeu_ps(&outBlock[i],
+			_mm_mul_ps(_mm_loadu_ps(&inTable[i]), amplitude));
+	}
+#endif
+	for (; i < inCount; i++)
+	{
+		outBlock[i] = inTable[i] * inAmplitude;
+	}
+}
+
+/*********************************** ToS16 ************************************/
+/*
+*	Converts samples in the range -1 to 1 to 16 bit, rounding to nearest and
+*	saturating.
+*/
+static inline void ToS16(
+	const float*	inBlock,
+	int16_t*		outBlock,
+	uint32_t		inCount)
+{
+	uint32_t	i = 0;
+#ifdef WWVB_SYNTHESIZER_SIMD
+	__m128	scale = _mm_set1_ps(32767.0f);
+	for (; (i + 8) <= inCount; i += 8)
+	{
+		__m128i	lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(&inBlock[i]), scale));
+		__m128i	hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(&inBlock[i + 4]), scale));
+		_mm_storeu_si128((__m128i*)&outBlock[i], _mm_packs_epi32(lo, hi));
+	}
+#endif
+	for (; i < inCount; i++)
+	{
+		float	sample = inBlock[i] * 32767.0f;
+		sample = sample > 32767.0f ? 32767.0f : (sample < -32768.0f ? -32768.0f : sample);
+		outBlock[i] = (int16_t)lrintf(sample);
+	}
+}
+
+/****************************** WWVBSynthesizer *******************************/
+WWVBSynthesizer::WWVBSynthesizer(
+	uint32_t				inSampleRate,
+	int32_t					inFrequency,
+	EOutput					inOutput,
+	const STimeCodeStation&	inStation)
+	: mStation(inStation), mSampleRate(inSampleRate), mFrequency(inFrequency),
+	  mOutput(inOutput), mChannels(inOutput == eBasebandCF32 ? 2 : 1), mPeriod(0), mPhase(0),
+	  mFill(0), mFullLevel(0.9f), mReducedLevel(0), mReducedRatio(0),
+	  mTableFloats(0), mPRN(false),
+	  mSink(FileSink), mSinkContext(stdout), mSinkFailed(false),
+	  mChannel(nullptr), mEdge(0), mEdgeOffset(0)
+{
+	SetReducedLevel(-17);
+	uint32_t	frequency = inFrequency < 0 ? -inFrequency : inFrequency;
+	bool		subharmonic = inOutput == eSubharmonicS16;
+	if (subharmonic)
+	{
+		frequency = (frequency % 3) == 0 ? (frequency / 3) : 0;
+	}
+	if (inSampleRate &&
+		(inSampleRate % 10) == 0 &&
+		(frequency || !subharmonic))
+	{
+		/*
+		*	The period is the fewest samples holding a whole number of
+		*	cycles.  The table holds one block past the end of a period so
+		*	any block can be read from any phase without wrapping.
+		*/
+		uint32_t	period = inSampleRate / GCD(inSampleRate, frequency % inSampleRate);
+		if (period <= kMaxPeriod)
+		{
+			/*
+			*	DCF77 adds tables advanced and retarded by the pseudo-random
+			*	phase deviation, but only once ePRN is first written.
+			*/
+			mPRN = &inStation == &TimeCodeStation::kDCF77 && !subharmonic;
+			mPeriod = period;
+			mTableFloats = (kBlockSamples + period) * mChannels;
+			mTable.resize(mTableFloats);
+			LoadTable(0);
+			mBlock.resize(kBlockSamples * mChannels);
+			if (inOutput == eCarrierS16 ||
+				subharmonic)
+			{
+				mS16Block.resize(kBlockSamples);
+			}
+		}
+	}
+}
+
+/********************************* LoadTable **********************************/
+/*
+*	Table 0 is the carrier, table 1 the carrier advanced by the DCF77 phase
+*	deviation and table 2 retarded by it.
+*/
+void WWVBSynthesizer::LoadTable(
+	uint32_t	inTable)
+{
+	const double	kTwoPi = 6.283185307179586476925;
+	uint32_t	frequency = mFrequency < 0 ? -mFrequency : mFrequency;
+	bool		subharmonic = mOutput == eSubharmonicS16;
+	uint32_t	tableSamples = mTableFloats / mChannels;
+	double		deviation = inTable ? (kTwoPi * DCF77PRN::kDeviation / 360) : 0;
+	float*		table = &mTable[inTable * mTableFloats];
+	if (subharmonic)
+	{
+		frequency /= 3;
+	}
+	if (inTable == 2)
+	{
+		deviation = -deviation;
+	}
+	for (uint32_t i = 0; i < tableSamples; i++)
+	{
+		// The phase is reduced with integers so it stays exact.
+		uint64_t	phase = ((uint64_t)i * frequency) % mSampleRate;
+		double		angle = kTwoPi * (double)phase / mSampleRate;
+		if (subharmonic)
+		{
+			/*
+			*	The third harmonic of a square wave is a third of its
+			*	amplitude, and inverting the square wave also inverts the
+			*	harmonic, so both the AM and PM carry over.
+			*/
+			table[i] = ((phase * 4) < mSampleRate ||
+							(phase * 4) >= ((uint64_t)mSampleRate * 3)) ? 1.0f : -1.0f;
+		} else if (mChannels == 1)
+		{
+			table[i] = (float)cos(angle + deviation);
+		} else
+		{
+			angle = (mFrequency < 0 ? -angle : angle) + deviation;
+			table[i * 2] = (float)cos(angle);
+			table[(i * 2) + 1] = (float)sin(angle);
+		}
+	}
+}
+
+/********************************** SetSink ***********************************/
+void WWVBSynthesizer::SetSink(
+	SampleSink	inSink,
+	void*		inContext)
+{
+	mSink = inSink;
+	mSinkContext = inContext;
+}
+
+/********************************** FileSink **********************************/
+bool WWVBSynthesizer::FileSink(
+	void*		inContext,
+	const void*	inData,
+	size_t		inBytes)
+{
+	return(fwrite(inData, 1, inBytes, (FILE*)inContext) == inBytes);
+}
+
+/********************************* SetChannel *********************************/
+void WWVBSynthesizer::SetChannel(
+	ChannelModel*	inChannel)
+{
+	mChannel = inChannel;
+}
+
+/******************************** SetAmplitude ********************************/
+void WWVBSynthesizer::SetAmplitude(
+	float	inAmplitude)
+{
+	mFullLevel = inAmplitude;
+	mReducedLevel = mFullLevel * mReducedRatio;
+}
+
+/****************************** SetReducedLevel *******************************/
+void WWVBSynthesizer::SetReducedLevel(
+	float	inDB)
+{
+	mReducedRatio = powf(10.0f, inDB / 20.0f);
+	mReducedLevel = mFullLevel * mReducedRatio;
+}
+
+/******************************** WriteSecond *********************************/
+uint32_t WWVBSynthesizer::WriteSecond(
+	uint32_t	inSymbol,
+	uint32_t	inSecond,
+	uint32_t	inPhase)
+{
+	uint32_t	pattern = mStation.Pattern(inSymbol, inSecond);
+	uint32_t	tenthSamples = mSampleRate / 10;
+	bool		prn = (inPhase & ePRN) && mPRN;
+	if (prn &&
+		mTable.size() == mTableFloats)
+	{
+		mTable.resize(mTableFloats * 3);
+		LoadTable(1);
+		LoadTable(2);
+	}
+	float		sign = inPhase == eInverted ? -1.0f : 1.0f;
+	uint32_t	tenth = 0;
+	uint32_t	written = 0;
+	bool		jitter = mChannel && mChannel->HasEdgeJitter();
+	/*
+	*	Runs of tenths at the same level are written as one.  Jitter moves
+	*	the edge at the end of each run, so the next run starts where this
+	*	one ended.
+	*/
+	while (tenth < 10)
+	{
+		uint32_t	reduced = (pattern >> tenth) & 1;
+		uint32_t	end = tenth + 1;
+		while (end < 10 &&
+			((pattern >> end) & 1) == reduced)
+		{
+			end++;
+		}
+		uint32_t	count = (end - tenth) * tenthSamples;
+		if (jitter)
+		{
+			int32_t	edgeOffset = mChannel->EdgeOffset(mEdge + end);
+			count += edgeOffset - mEdgeOffset;
+			mEdgeOffset = edgeOffset;
+		}
+		if (prn)
+		{
+			WritePRN((reduced ? mReducedLevel : mFullLevel) * sign, written,
+						count, inPhase & 1);
+		} else
+		{
+			WriteSamples((reduced ? mReducedLevel : mFullLevel) * sign, count);
+		}
+		written += count;
+		tenth = end;
+	}
+	mEdge += 10;
+	return(written);
+}
+
+/******************************** WriteSecond *********************************/
+uint32_t WWVBSynthesizer::WriteSecond(
+	const SWWVBPackedFrame&	inFrame,
+	const SWWVBPMFrame*		inPMFrame,
+	uint32_t				inSecond)
+{
+	return(WriteSecond(inFrame.GetSymbol(inSecond), inSecond,
+					inPMFrame ? inPMFrame->GetPhase(inSecond) : 0));
+}
+
+/*********************************** Stream ***********************************/
+bool WWVBSynthesizer::Stream(
+	time32_t	inStart,
+	uint32_t	inSeconds,
+	bool		inPhaseModulation,
+	uint64_t&	outSamples)
+{
+	uint64_t			samples = 0;
+	uint32_t			written;
+	bool				isWWVB = &mStation == &TimeCodeStation::kWWVB;
+	SWWVBPackedFrame	frame;
+	SWWVBPMFrame		pmFrame;
+	TimeCodeEncoder		encoder(mStation);
+	for (uint32_t i = 0; i < inSeconds; i++)
+	{
+		time32_t	time = inStart + i;
+		uint32_t	second = time % 60;
+		if (isWWVB)
+		{
+			if (i == 0 ||
+				second == 0)
+			{
+				UnixTimeWWVB::LoadPackedFrame(time, frame);
+				UnixTimeWWVB::LoadPMFrame(time, pmFrame);
+			}
+			written = WriteSecond(frame, inPhaseModulation ? &pmFrame : nullptr, second);
+		} else
+		{
+			uint32_t	symbol = encoder.Encode(time).GetSymbol(second);
+			written = WriteSecond(symbol, second,
+							inPhaseModulation ? (ePRN | (symbol & 1)) : 0);
+		}
+		if (mSinkFailed)
+		{
+			break;
+		}
+		samples += written;
+	}
+	outSamples = samples;
+	return(Flush());
+}
+
+/******************************** WriteSamples ********************************/
+void WWVBSynthesizer::WriteSamples(
+	float		inAmplitude,
+	uint32_t	inCount,
+	uint32_t	inTable)
+{
+	const float*	table = &mTable[inTable * mTableFloats];
+	while (inCount)
+	{
+		uint32_t	count = kBlockSamples - mFill;
+		if (count > inCount)
+		{
+			count = inCount;
+		}
+		ScaleBlock(&table[mPhase * mChannels], inAmplitude,
+					&mBlock[mFill * mChannels], count * mChannels);
+		mPhase = (mPhase + count) % mPeriod;
+		mFill += count;
+		inCount -= count;
+		if (mFill == kBlockSamples)
+		{
+			WriteBlock();
+		}
+	}
+}
+
+/********************************** WritePRN **********************************/
+/*
+*	Writes inCount samples starting inPosition samples into the second,
+*	switching tables at the chip boundaries of the pseudo-random sequence.
+*/
+void WWVBSynthesizer::WritePRN(
+	float		inAmplitude,
+	uint32_t	inPosition,
+	uint32_t	inCount,
+	uint32_t	inTimeBit)
+{
+	uint32_t	end = inPosition + inCount;
+	uint32_t	first = DCF77PRN::ChipStart(0, mSampleRate);
+	uint32_t	last = DCF77PRN::ChipStart(DCF77PRN::kChips, mSampleRate);
+	while (inPosition < end)
+	{
+		uint32_t	next = end;
+		uint32_t	table = 0;
+		if (inPosition < first)
+		{
+			next = first < end ? first : end;
+		} else if (inPosition < last)
+		{
+			uint32_t	chip = (uint32_t)(((uint64_t)(inPosition - first) * DCF77PRN::kCarrierHz) /
+									((uint64_t)DCF77PRN::kCyclesPerChip * mSampleRate));
+			// The chip starts are rounded, so the estimate may be off by one.
+			if (DCF77PRN::ChipStart(chip, mSampleRate) > inPosition)
+			{
+				chip--;
+			} else if (DCF77PRN::ChipStart(chip + 1, mSampleRate) <= inPosition)
+			{
+				chip++;
+			}
+			uint32_t	chipEnd = DCF77PRN::ChipStart(chip + 1, mSampleRate);
+			next = chipEnd < end ? chipEnd : end;
+			table = (DCF77PRN::Chip(chip) ^ inTimeBit) ? 2 : 1;
+		}
+		WriteSamples(inAmplitude, next - inPosition, table);
+		inPosition = next;
+	}
+}
+
+/*********************************** Flush ************************************/
+bool WWVBSynthesizer::Flush(void)
+{
+	WriteBlock();
+	bool	succeeded = !mSinkFailed;
+	mSinkFailed = false;
+	return(succeeded);
+}
+
+/********************************* WriteBlock *********************************/
+/*
+*	Passes the block to the sink.  A failure is kept in mSinkFailed until
+*	the next Flush(), so that Stream() can stop at it.
+*/
+void WWVBSynthesizer::WriteBlock(void)
+{
+	if (mFill)
+	{
+		bool	written;
+		if (mChannel)
+		{
+			mChannel->Process(mBlock.data(), mFill);
+		}
+		if (mS16Block.size())
+		{
+			ToS16(mBlock.data(), mS16Block.data(), mFill);
+			written = mSink(mSinkContext, mS16Block.data(), mFill * sizeof(int16_t));
+		} else
+		{
+			written = mSink(mSinkContext, mBlock.data(), mFill * sizeof(float) * mChannels);
+		}
+		mSinkFailed = mSinkFailed || !written;
+		mFill = 0;
+	}
+}
+
+/******************************* InstructionSet *******************************/
+const char* WWVBSynthesizer::InstructionSet(void)
+{
+#if defined __AVX2__
+	return("AVX2");
+#elif defined __SSE2__
+	return("SSE2");
+#else
+	return("scalar");
+#endif
+}
+#endif
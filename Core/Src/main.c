@@ -109,6 +109,7 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
+    UnixTimeWWVB::PrepareNextFrame();
   }
   /* USER CODE END 3 */
 }
@@ -0,0 +1,240 @@
+/*
+*	BatchBench.cpp, Copyright Jonathan Mackey 2026
+*
+*	Throughput benchmark of UnixTimeBatch in conversions per second, for
+*	both output layouts against the scalar ToComponents loop.  The batch
+*	path is the one the build selects (see UnixTimeBatch::InstructionSet),
+*	so build once per instruction set.  Every batch result is checked
+*	against the scalar path, and the tool exits with 1 on any mismatch.
+*
+*	Build from the project directory:
+*		SSE2:	g++ -std=gnu++14 -O2 -ICore/Inc Host/BatchBench.cpp \
+*					$(find Core/Src -name '[A-Z]*.cpp') -o batchbench
+*		AVX2:	add -mavx2 (or -march=native)
+*		scalar:	add -DUNIX_TIME_BATCH_SCALAR
+*
+*	Example:
+*		./batchbench -n 16000000 -r 10
+*		./batchbench -a		(checks all 2^32 times, takes a while)
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "UnixTimeBatch.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+typedef UnixTimeConverter<time32_t>	Scalar;
+
+/*********************************** Usage ************************************/
+static void Usage(void)
+{
+	fprintf(stderr,
+		"usage: batchbench [options]\n"
+		"  -n count     Times per pass (default 16000000)\n"
+		"  -r passes    Passes per measurement, the fastest is reported (default 5)\n"
+		"  -S seed      Seed of the random times (default 1)\n"
+		"  -a           Check every time32_t rather than benchmark\n");
+}
+
+/************************************ Same ************************************/
+static inline bool Same(
+	const UnixTimeBatch::SComponents&	inA,
+	const UnixTimeBatch::SComponents&	inB)
+{
+	return(inA.second == inB.second &&
+			inA.minute == inB.minute &&
+			inA.hour == inB.hour &&
+			inA.day == inB.day &&
+			inA.month == inB.month &&
+			inA.year == inB.year);
+}
+
+/************************************ Rate ************************************/
+/*
+*	Returns the conversions per second of inFunction, which converts
+*	inCount times, over the fastest of inPasses calls.
+*/
+template <class TFunction>
+static double Rate(
+	TFunction	inFunction,
+	size_t		inCount,
+	uint32_t	inPasses)
+{
+	double	fastest = 0;
+	for (uint32_t pass = 0; pass < inPasses; pass++)
+	{
+		std::chrono::steady_clock::time_point	startTime = std::chrono::steady_clock::now();
+		inFunction();
+		double	elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+												startTime).count();
+		if (pass == 0 || elapsed < fastest)
+		{
+			fastest = elapsed;
+		}
+	}
+	return(fastest > 0 ? (inCount / fastest) : 0);
+}
+
+/********************************** CheckAll **********************************/
+/*
+*	Returns the number of times from 0 to 0xFFFFFFFF for which either batch
+*	layout differs from the scalar path.
+*/
+static uint64_t CheckAll(void)
+{
+	const uint32_t	kBlock = 65536;
+	std::vector<time32_t>					times(kBlock);
+	std::vector<UnixTimeBatch::SComponents>	batch(kBlock);
+	std::vector<uint8_t>					bytes(kBlock * 5);
+	std::vector<uint16_t>					years(kBlock);
+	UnixTimeBatch::SComponentsSoA	soa = {&bytes[0], &bytes[kBlock], &bytes[kBlock * 2],
+											&bytes[kBlock * 3], &bytes[kBlock * 4], years.data()};
+	uint64_t	mismatches = 0;
+	for (uint64_t start = 0; start <= 0xFFFFFFFF; start += kBlock)
+	{
+		for (uint32_t i = 0; i < kBlock; i++)
+		{
+			times[i] = (time32_t)(start + i);
+		}
+		UnixTimeBatch::ToComponentsBatch(times.data(), kBlock, batch.data());
+		UnixTimeBatch::ToComponentsBatch(times.data(), kBlock, soa);
+		for (uint32_t i = 0; i < kBlock; i++)
+		{
+			UnixTimeBatch::SComponents	scalar;
+			Scalar::ToComponents(times[i], scalar);
+			UnixTimeBatch::SComponents	column = {soa.second[i], soa.minute[i], soa.hour[i],
+											soa.day[i], soa.month[i], soa.year[i]};
+			if (!Same(scalar, batch[i]) ||
+				!Same(scalar, column))
+			{
+				if (mismatches++ < 10)
+				{
+					fprintf(stderr, "Mismatch at %u\n", times[i]);
+				}
+			}
+		}
+	}
+	return(mismatches);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	size_t		count = 16000000;
+	uint32_t	passes = 5;
+	uint64_t	seed = 1;
+	bool		checkAll = false;
+	int			option;
+	while ((option = getopt(argc, argv, "n:r:S:ah")) != -1)
+	{
+		switch (option)
+		{
+			case 'n':
+				count = (size_t)strtoull(optarg, nullptr, 10);
+				break;
+			case 'r':
+				passes = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'S':
+				seed = strtoull(optarg, nullptr, 0);
+				break;
+			case 'a':
+				checkAll = true;
+				break;
+			default:
+				Usage();
+				return(1);
+		}
+	}
+	if (optind < argc ||
+		count == 0 ||
+		passes == 0)
+	{
+		Usage();
+		return(1);
+	}
+	printf("Batch path: %s\n", UnixTimeBatch::InstructionSet());
+	if (checkAll)
+	{
+		uint64_t	mismatches = CheckAll();
+		printf("%llu mismatches over all times\n", (unsigned long long)mismatches);
+		return(mismatches ? 1 : 0);
+	}
+	/*
+	*	Uniformly random times (splitmix64) so that no month, year or
+	*	time of day is favored.
+	*/
+	std::vector<time32_t>	times(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		uint64_t	z = (seed += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		times[i] = (time32_t)(z ^ (z >> 31));
+	}
+	std::vector<UnixTimeBatch::SComponents>	scalar(count);
+	std::vector<UnixTimeBatch::SComponents>	batch(count);
+	std::vector<uint8_t>					bytes(count * 5);
+	std::vector<uint16_t>					years(count);
+	UnixTimeBatch::SComponentsSoA	soa = {&bytes[0], &bytes[count], &bytes[count * 2],
+											&bytes[count * 3], &bytes[count * 4], years.data()};
+	double	scalarRate = Rate([&]()
+					{
+						for (size_t i = 0; i < count; i++)
+						{
+							Scalar::ToComponents(times[i], scalar[i]);
+						}
+					}, count, passes);
+	double	batchRate = Rate([&]()
+					{
+						UnixTimeBatch::ToComponentsBatch(times.data(), count, batch.data());
+					}, count, passes);
+	double	soaRate = Rate([&]()
+					{
+						UnixTimeBatch::ToComponentsBatch(times.data(), count, soa);
+					}, count, passes);
+	size_t	mismatches = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		UnixTimeBatch::SComponents	column = {soa.second[i], soa.minute[i], soa.hour[i],
+										soa.day[i], soa.month[i], soa.year[i]};
+		if (!Same(scalar[i], batch[i]) ||
+			!Same(scalar[i], column))
+		{
+			if (mismatches++ < 10)
+			{
+				fprintf(stderr, "Mismatch at %u\n", times[i]);
+			}
+		}
+	}
+	printf("                         M conversions/s  speedup\n");
+	printf("Scalar ToComponents      %15.1f\n", scalarRate / 1e6);
+	printf("Batch, SComponents       %15.1f  %7.2f\n", batchRate / 1e6,
+		scalarRate > 0 ? (batchRate / scalarRate) : 0);
+	printf("Batch, SComponentsSoA    %15.1f  %7.2f\n", soaRate / 1e6,
+		scalarRate > 0 ? (soaRate / scalarRate) : 0);
+	printf("%zu mismatches in %zu times\n", mismatches, count);
+	return(mismatches ? 1 : 0);
+}
@@ -0,0 +1,231 @@
+/*
+*	CalendarBench.cpp, Copyright Jonathan Mackey 2026
+*
+*	Microbenchmark of UnixTime::ToComponents and FromComponents (see
+*	CivilCalendar) against the month table implementation they replaced,
+*	which is reproduced here.  The results of both are compared over the
+*	range the old code handled, 2000 to 2099, and the tool exits with 1 on
+*	any mismatch.
+*
+*	Build from the project directory:
+*		g++ -std=gnu++14 -O2 -ICore/Inc Host/CalendarBench.cpp \
+*			$(find Core/Src -name '[A-Z]*.cpp') -o calendarbench
+*
+*	Example:
+*		./calendarbench -n 50000000
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "UnixTime.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+*	The conversions as they were before CivilCalendar.  Every year divisible
+*	by 4 is a leap year and FromComponents only handles 2000 to 2099.  They
+*	aren't inlined, as the library's conversions can't be.
+*/
+namespace Legacy
+{
+const uint32_t	kOneDay = 86400;
+const uint32_t	kOneYear = 31557600;
+const uint32_t	kDaysInFourYears = 1461;
+const time32_t	kYear2000 = 946684800;
+const uint16_t	kDaysTo[] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+const uint16_t	kDaysToLY[] = {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335};
+
+/***************************** LegacyToComponents *****************************/
+static void __attribute__((noinline)) LegacyToComponents(
+	time32_t					inTime,
+	UnixTime::SComponents&		outComponents)
+{
+	inTime -= (365*2*kOneDay);	// Start from 1972, the first leap year after 1970
+	time32_t	timeComp = inTime%kOneDay;
+	inTime -= timeComp;
+	outComponents.year = (inTime/kOneYear) + 1972;
+	uint16_t	day = ((inTime % kOneYear) / kOneDay) + 1;
+	const uint16_t*	daysTo = ((inTime/kOneDay) % kDaysInFourYears) <= 365 ? kDaysToLY : kDaysTo;
+	uint8_t month = 1;
+	for (; month < 12; month++)
+	{
+		if (day > daysTo[month])
+		{
+			continue;
+		}
+		break;
+	}
+	outComponents.month = month;
+	outComponents.day = day - daysTo[month-1];
+	outComponents.second = timeComp % 60;
+	timeComp /= 60;
+	outComponents.minute = timeComp % 60;
+	timeComp /= 60;
+	outComponents.hour = timeComp % 24;
+}
+
+/**************************** LegacyFromComponents ****************************/
+static time32_t __attribute__((noinline)) LegacyFromComponents(
+	const UnixTime::SComponents&	inComponents)
+{
+	time32_t time = kYear2000;
+	uint16_t	year = inComponents.year % 2000;
+	time += (year * 31536000);
+	{
+		uint16_t	days = kDaysTo[inComponents.month-1] + inComponents.day;
+		if (inComponents.month > 2 &&
+			(year % 4) == 0)
+		{
+			days++;
+		}
+		// Account for leap year days since 2000
+		days += (((year+3)/4)-1);
+		time += (days * kOneDay);
+	}
+	time += (((uint32_t)inComponents.hour) * 3600);
+	time += (inComponents.minute * 60);
+	time += inComponents.second;
+	return(time);
+}
+}
+
+/*********************************** Usage ************************************/
+static void Usage(void)
+{
+	fprintf(stderr,
+		"usage: calendarbench [options]\n"
+		"  -n count     Conversions per measurement (default 20000000)\n");
+}
+
+/********************************* Benchmark **********************************/
+/*
+*	Returns the nanoseconds per call of inFunction(i) for i = 0 to
+*	inCount - 1.  The sum of the results is added to ioSum so the calls
+*	can't be optimized away.
+*/
+template <class TFunction>
+static double Benchmark(
+	TFunction	inFunction,
+	uint32_t	inCount,
+	uint32_t&	ioSum)
+{
+	uint32_t	sum = 0;
+	std::chrono::steady_clock::time_point	startTime = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < inCount; i++)
+	{
+		sum += inFunction(i);
+	}
+	double	elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+											startTime).count();
+	ioSum += sum;
+	return(inCount ? (elapsed * 1e9 / inCount) : 0);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	const time32_t	kYear2100 = 4102444800;
+	uint32_t	count = 20000000;
+	int			option;
+	while ((option = getopt(argc, argv, "n:h")) != -1)
+	{
+		switch (option)
+		{
+			case 'n':
+				count = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			default:
+				Usage();
+				return(1);
+		}
+	}
+	if (optind < argc)
+	{
+		Usage();
+		return(1);
+	}
+	/*
+	*	Both implementations must agree from 2000 to 2099.  The step is
+	*	prime so every time of day and day of the month is visited.
+	*/
+	uint32_t	mismatches = 0;
+	for (time32_t time = Legacy::kYear2000; time < kYear2100; time += 7919)
+	{
+		UnixTime::SComponents	components;
+		UnixTime::SComponents	legacy;
+		UnixTime::ToComponents(time, components);
+		Legacy::LegacyToComponents(time, legacy);
+		if (components.second != legacy.second ||
+			components.minute != legacy.minute ||
+			components.hour != legacy.hour ||
+			components.day != legacy.day ||
+			components.month != legacy.month ||
+			components.year != legacy.year ||
+			UnixTime::FromComponents(components) != time ||
+			Legacy::LegacyFromComponents(components) != time)
+		{
+			if (mismatches++ < 10)
+			{
+				fprintf(stderr, "Mismatch at %u\n", time);
+			}
+		}
+	}
+	/*
+	*	The times are spread over 2000 to 2099 so the old month loop runs
+	*	its full range of iterations.
+	*/
+	const uint32_t	kStride = (kYear2100 - Legacy::kYear2000) / (count ? count : 1);
+	uint32_t	sum = 0;
+	double		toComponents = Benchmark([=](uint32_t inIndex)
+					{
+						UnixTime::SComponents	components;
+						UnixTime::ToComponents(Legacy::kYear2000 + (inIndex * kStride), components);
+						return(components.day + components.month + components.year);
+					}, count, sum);
+	double		legacyToComponents = Benchmark([=](uint32_t inIndex)
+					{
+						UnixTime::SComponents	components;
+						Legacy::LegacyToComponents(Legacy::kYear2000 + (inIndex * kStride), components);
+						return(components.day + components.month + components.year);
+					}, count, sum);
+	double		fromComponents = Benchmark([](uint32_t inIndex)
+					{
+						UnixTime::SComponents	components = {(uint8_t)(inIndex % 60),
+							(uint8_t)(inIndex % 59), (uint8_t)(inIndex % 24),
+							(uint8_t)(1 + (inIndex % 28)), (uint8_t)(1 + (inIndex % 12)),
+							(uint16_t)(2000 + (inIndex % 100))};
+						return(UnixTime::FromComponents(components));
+					}, count, sum);
+	double		legacyFromComponents = Benchmark([](uint32_t inIndex)
+					{
+						UnixTime::SComponents	components = {(uint8_t)(inIndex % 60),
+							(uint8_t)(inIndex % 59), (uint8_t)(inIndex % 24),
+							(uint8_t)(1 + (inIndex % 28)), (uint8_t)(1 + (inIndex % 12)),
+							(uint16_t)(2000 + (inIndex % 100))};
+						return(Legacy::LegacyFromComponents(components));
+					}, count, sum);
+	printf("                 CivilCalendar  month table  ns/call\n");
+	printf("ToComponents     %13.2f  %11.2f\n", toComponents, legacyToComponents);
+	printf("FromComponents   %13.2f  %11.2f\n", fromComponents, legacyFromComponents);
+	fprintf(stderr, "checksum %08x, %u mismatches\n", sum, mismatches);
+	return(mismatches ? 1 : 0);
+}
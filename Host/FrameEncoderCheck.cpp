@@ -0,0 +1,190 @@
+/*
+*	FrameEncoderCheck.cpp, Copyright Jonathan Mackey 2026
+*
+*	Checks that the incremental WWVBFrameEncoder sends the same frame as
+*	UnixTimeWWVB::LoadTimeCodeStruct for every minute of runs of
+*	consecutive minutes.  Runs start at random minutes from 1972 to 2105,
+*	and every other run starts shortly before a year end, a leap second or
+*	a DUT1 change so that the rarely changing fields are carried as well.
+*	Two leap seconds (one negative) and random DUT1 changes are added to
+*	the tables first.  Prints the first mismatches and exits with 1 if
+*	there were any.
+*
+*	Build from the project directory:
+*		g++ -std=gnu++14 -O2 -ICore/Inc Host/FrameEncoderCheck.cpp \
+*			$(find Core/Src -name '[A-Z]*.cpp') -o frameencodercheck
+*
+*	Example, 100000 runs of two days:
+*		./frameencodercheck -n 100000 -m 2880
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "WWVBFrameEncoder.h"
+#include "CivilCalendar.h"
+#include "DUT1Schedule.h"
+#include "LeapSeconds.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+const time32_t	kFirstTime = 63072000;		// 1-JAN-1972
+const time32_t	kLastTime = 4291747200;		// 1-FEB-2106
+
+/*********************************** Usage ************************************/
+static void Usage(void)
+{
+	fprintf(stderr,
+		"usage: frameencodercheck [options]\n"
+		"  -n runs      Runs of consecutive minutes (default 20000)\n"
+		"  -m minutes   Minutes per run (default 1440)\n"
+		"  -S seed      Seed (default 1)\n");
+}
+
+/*********************************** Random ***********************************/
+/*
+*	splitmix64
+*/
+static uint64_t Random(
+	uint64_t&	ioSeed)
+{
+	uint64_t	z = (ioSeed += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return(z ^ (z >> 31));
+}
+
+/********************************* MonthStart *********************************/
+static time32_t MonthStart(
+	uint16_t	inYear,
+	uint8_t		inMonth)
+{
+	return((CivilCalendar::DaysFromCivil(inYear, inMonth, 1) -
+				CivilCalendar::kUnixEpochDays) * 86400);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	runs = 20000;
+	uint32_t	minutes = 1440;
+	uint64_t	seed = 1;
+	int			option;
+	while ((option = getopt(argc, argv, "n:m:S:h")) != -1)
+	{
+		switch (option)
+		{
+			case 'n':
+				runs = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'm':
+				minutes = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'S':
+				seed = strtoull(optarg, nullptr, 0);
+				break;
+			default:
+				Usage();
+				return(1);
+		}
+	}
+	if (optind < argc ||
+		runs == 0 ||
+		minutes == 0 ||
+		minutes > 525600)
+	{
+		Usage();
+		return(1);
+	}
+	/*
+	*	The times the runs aimed at a boundary end up crossing.
+	*/
+	std::vector<time32_t>	boundaries;
+	LeapSeconds::AddLeapSecond(MonthStart(2030, 1), 1);
+	LeapSeconds::AddLeapSecond(MonthStart(2035, 7), -1);
+	for (time32_t time = kFirstTime;;)
+	{
+		time32_t	leapSecondTime;
+		int8_t		delta;
+		if (!LeapSeconds::NextLeapSecond(time, leapSecondTime, delta))
+		{
+			break;
+		}
+		boundaries.push_back(leapSecondTime);
+		time = leapSecondTime;
+	}
+	for (uint8_t i = 1; i < DUT1Schedule::kMaxEntries; i++)
+	{
+		time32_t	time = MonthStart(1972 + (Random(seed) % 134), 1) +
+								(time32_t)(Random(seed) % 365) * 86400;
+		DUT1Schedule::AddEntry(time, (int8_t)(Random(seed) % 19) - 9);
+		boundaries.push_back(time);
+	}
+	for (uint16_t year = 1973; year <= 2105; year++)
+	{
+		boundaries.push_back(MonthStart(year, 1));
+	}
+
+	WWVBFrameEncoder	encoder;
+	SWWVBTimeCode		timeCode;
+	uint64_t	frames = 0;
+	uint64_t	mismatches = 0;
+	for (uint32_t run = 0; run < runs; run++)
+	{
+		time32_t	time;
+		if (run & 1)
+		{
+			time = boundaries[Random(seed) % boundaries.size()] -
+						(time32_t)(Random(seed) % minutes) * 60;
+		} else
+		{
+			time = kFirstTime + (time32_t)(Random(seed) % (kLastTime - kFirstTime));
+		}
+		time -= time % 60;
+		if (time < kFirstTime ||
+			time > (kLastTime - minutes * 60))
+		{
+			continue;
+		}
+		for (uint32_t minute = 0; minute < minutes; minute++, time += 60)
+		{
+			const SWWVBPackedFrame&	frame = encoder.Encode(time);
+			UnixTimeWWVB::LoadTimeCodeStruct(time, timeCode);
+			const uint8_t*	expected = (const uint8_t*)&timeCode;
+			frames++;
+			for (uint32_t second = 0; second < 60; second++)
+			{
+				if (frame.GetSymbol(second) != expected[second])
+				{
+					if (mismatches++ < 10)
+					{
+						fprintf(stderr, "Mismatch at %u second %u, %u instead of %u\n",
+							time, second, frame.GetSymbol(second), expected[second]);
+					}
+					break;
+				}
+			}
+		}
+	}
+	printf("%llu frames, %llu mismatches\n", (unsigned long long)frames,
+				(unsigned long long)mismatches);
+	return(mismatches ? 1 : 0);
+}
@@ -0,0 +1,235 @@
+/*
+*	LeapSecondCheck.cpp, Copyright Jonathan Mackey 2026
+*
+*	Checks that UnixClock ticks through leap seconds.  At the end of every
+*	month in the range the clock is ticked through a positive leap second
+*	(23:59:59, 23:59:60, 00:00:00) and a negative one (23:59:58, 00:00:00),
+*	and through the same minute after SetTime() has cancelled the leap
+*	second.  A default clock is ticked from time 0, which must not be taken
+*	for a leap second.  After each tick Time() and the components must be
+*	as expected, and away from the leap second the components, day of year
+*	and day of week must match those derived from Time().  The $PLEAP
+*	sentences that request UnixTimeWWVB::SimulateLeapSecond() are parsed
+*	too.  Prints each failure and exits with 1 if there were any.
+*
+*	Build from the project directory:
+*		g++ -std=gnu++14 -O2 -ICore/Inc Host/LeapSecondCheck.cpp \
+*			$(find Core/Src -name '[A-Z]*.cpp') -o leapsecondcheck
+*
+*	Example, the month ends of 1972 through 2105:
+*		./leapsecondcheck -s 1972 -e 2105
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "UnixClock.h"
+#include "CivilCalendar.h"
+#include "LeapSeconds.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static uint32_t	sFailures;
+
+/*********************************** Usage ************************************/
+static void Usage(void)
+{
+	fprintf(stderr,
+		"usage: leapsecondcheck [options]\n"
+		"  -s year      First year (default 1972)\n"
+		"  -e year      Last year (default 2105)\n");
+}
+
+/********************************* CheckTick **********************************/
+/*
+*	Ticks inClock and checks that Time() is inTime and the components are
+*	those of inTime, except that the seconds are inSecond.
+*/
+static void CheckTick(
+	UnixClock&	inClock,
+	time32_t	inTime,
+	uint8_t		inSecond,
+	const char*	inCase)
+{
+	inClock.Tick();
+	SUnixTimeComponents	expected;
+	UnixClock::ToComponents(inTime, expected);
+	expected.second = inSecond;
+	const SUnixTimeComponents&	components = inClock.CurrentComponents();
+	bool	valid = inClock.Time() == inTime &&
+					components.year == expected.year &&
+					components.month == expected.month &&
+					components.day == expected.day &&
+					components.hour == expected.hour &&
+					components.minute == expected.minute &&
+					components.second == expected.second;
+	if (valid &&
+		inSecond < 60)
+	{
+		valid = inClock.CurrentDayOfYear() ==
+					CivilCalendar::DayOfYear(expected.year, expected.month, expected.day) &&
+				inClock.CurrentDayOfWeek() == UnixClock::DayOfWeek(inTime);
+	}
+	if (!valid)
+	{
+		fprintf(stderr, "%s: expected %u %04u-%02u-%02u %02u:%02u:%02u, got "
+			"%u %04u-%02u-%02u %02u:%02u:%02u day %u/%u\n", inCase,
+			(unsigned)inTime, expected.year, expected.month, expected.day,
+			expected.hour, expected.minute, expected.second,
+			(unsigned)inClock.Time(), components.year, components.month,
+			components.day, components.hour, components.minute,
+			components.second, inClock.CurrentDayOfYear(),
+			inClock.CurrentDayOfWeek());
+		sFailures++;
+	}
+}
+
+/****************************** CheckNormalTicks ******************************/
+/*
+*	Ticks inClock inTicks times from inTime, none of them a leap second.
+*/
+static void CheckNormalTicks(
+	UnixClock&	inClock,
+	time32_t	inTime,
+	uint32_t	inTicks,
+	const char*	inCase)
+{
+	for (uint32_t i = 1; i <= inTicks; i++)
+	{
+		time32_t	time = inTime + i;
+		CheckTick(inClock, time, (uint8_t)(time % 60), inCase);
+	}
+}
+
+/******************************* CheckMonthEnd ********************************/
+/*
+*	inTime is 00:00:00 on the first of a month, when the new TAI-UTC takes
+*	effect.
+*/
+static void CheckMonthEnd(
+	time32_t	inTime)
+{
+	UnixClock	clock;
+	clock.SetTime(inTime - 3);
+	clock.ScheduleLeapSecond(inTime, 1);
+	CheckTick(clock, inTime - 2, 58, "+1");
+	CheckTick(clock, inTime - 1, 59, "+1");
+	CheckTick(clock, inTime - 1, 60, "+1");
+	CheckTick(clock, inTime, 0, "+1");
+	CheckNormalTicks(clock, inTime, 70, "+1");
+
+	clock.SetTime(inTime - 3);
+	clock.ScheduleLeapSecond(inTime, -1);
+	CheckTick(clock, inTime - 2, 58, "-1");
+	CheckTick(clock, inTime, 0, "-1");
+	CheckNormalTicks(clock, inTime, 70, "-1");
+
+	clock.SetTime(inTime - 100);
+	clock.ScheduleLeapSecond(inTime, 1);
+	clock.SetTime(inTime - 3);
+	CheckNormalTicks(clock, inTime - 3, 70, "cancelled");
+}
+
+/******************************* CheckSentence ********************************/
+static void CheckSentence(
+	const char*	inBody,		// Between $ and *
+	bool		inValid,
+	int8_t		inDelta)
+{
+	uint8_t	crc = 0;
+	for (const char* bodyPtr = inBody; *bodyPtr; bodyPtr++)
+	{
+		crc ^= (uint8_t)*bodyPtr;
+	}
+	char	sentence[32];
+	snprintf(sentence, sizeof(sentence), "$%s*%02X", inBody, crc);
+	int8_t	delta = 0;
+	bool	valid = LeapSeconds::ParseSentence(sentence, delta);
+	if (valid != inValid ||
+		(valid && delta != inDelta))
+	{
+		fprintf(stderr, "%s: expected %s %d, got %s %d\n", sentence,
+			inValid ? "valid" : "invalid", inDelta,
+			valid ? "valid" : "invalid", delta);
+		sFailures++;
+	}
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint16_t	firstYear = 1972;
+	uint16_t	lastYear = 2105;
+	int			option;
+	while ((option = getopt(argc, argv, "s:e:h")) != -1)
+	{
+		switch (option)
+		{
+			case 's':
+				firstYear = (uint16_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'e':
+				lastYear = (uint16_t)strtoul(optarg, nullptr, 10);
+				break;
+			default:
+				Usage();
+				return(1);
+		}
+	}
+	if (optind < argc ||
+		firstYear < 1970 ||
+		lastYear > 2105 ||
+		firstYear > lastYear)
+	{
+		Usage();
+		return(1);
+	}
+	uint32_t	monthEnds = 0;
+	for (uint16_t year = firstYear; year <= lastYear; year++)
+	{
+		for (uint8_t month = 1; month <= 12; month++)
+		{
+			time32_t	time = (CivilCalendar::DaysFromCivil(year, month, 1) -
+								CivilCalendar::kUnixEpochDays) * 86400;
+			// The clock can't be set before time 0
+			if (time >= 3)
+			{
+				CheckMonthEnd(time);
+				monthEnds++;
+			}
+		}
+	}
+	UnixClock	clock;
+	CheckNormalTicks(clock, 0, 120, "time 0");
+
+	CheckSentence("PLEAP,+1", true, 1);
+	CheckSentence("PLEAP,-1", true, -1);
+	CheckSentence("PLEAP,1", false, 0);
+	CheckSentence("PLEAP,+2", false, 0);
+	CheckSentence("PDUT1,+1", false, 0);
+	int8_t	delta;
+	if (LeapSeconds::ParseSentence("$PLEAP,+1*00", delta))
+	{
+		fprintf(stderr, "$PLEAP,+1*00: bad checksum accepted\n");
+		sFailures++;
+	}
+	printf("%u month ends, %u failures\n", monthEnds, sFailures);
+	return(sFailures ? 1 : 0);
+}
@@ -0,0 +1,172 @@
+/*
+*	PRNCheck.cpp, Copyright Jonathan Mackey 2026
+*
+*	Checks the DCF77 pseudo-random phase modulation sent by WWVBSynthesizer
+*	using DCF77PRN::Correlate().  Each second of synthesized baseband is
+*	correlated with the chip sequence at lag 0, which must be near 1 for
+*	time bit 0 and near -1 for time bit 1, and at lags 1 to 16 and every
+*	32 chips in both directions, which must all be near 0.  Prints each
+*	failing second and exits with 1 if there were any.  With -N the check
+*	is of the noisy signal, so a low enough SNR is expected to fail.
+*
+*	Build from the project directory:
+*		g++ -std=gnu++14 -O2 -ICore/Inc Host/PRNCheck.cpp \
+*			$(find Core/Src -name '[A-Z]*.cpp') -o prncheck
+*
+*	Example, ten minutes at 20 dB SNR:
+*		./prncheck -n 600 -N 20
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "DCF77PRN.h"
+#include "WWVBSynthesizer.h"
+#include "ChannelModel.h"
+#include "TimeCodeEncoder.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+const float	kMinPeak = 0.8f;		// Lag 0
+const float	kMaxSidelobe = 0.1f;	// Any other lag
+
+/*********************************** Usage ************************************/
+static void Usage(void)
+{
+	fprintf(stderr,
+		"usage: prncheck [options]\n"
+		"  -t time      Start, Unix time (default 1700000000)\n"
+		"  -n seconds   Length (default 60)\n"
+		"  -r rate      Sample rate in Hz, a multiple of 10 (default 100000)\n"
+		"  -N dB        White noise at this SNR over the sample bandwidth\n"
+		"  -S seed      Seed of the noise (default 1)\n");
+}
+
+/********************************* VectorSink *********************************/
+static bool VectorSink(
+	void*		inContext,
+	const void*	inData,
+	size_t		inBytes)
+{
+	std::vector<float>*	samples = (std::vector<float>*)inContext;
+	const float*		data = (const float*)inData;
+	samples->insert(samples->end(), data, data + (inBytes / sizeof(float)));
+	return(true);
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	time32_t	start = 1700000000;
+	uint32_t	seconds = 60;
+	uint32_t	sampleRate = 100000;
+	float		snr = NAN;
+	uint64_t	seed = 1;
+	int			option;
+	while ((option = getopt(argc, argv, "t:n:r:N:S:h")) != -1)
+	{
+		switch (option)
+		{
+			case 't':
+				start = (time32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'n':
+				seconds = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'r':
+				sampleRate = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'N':
+				snr = strtof(optarg, nullptr);
+				break;
+			case 'S':
+				seed = strtoull(optarg, nullptr, 10);
+				break;
+			default:
+				Usage();
+				return(1);
+		}
+	}
+	WWVBSynthesizer	synthesizer(sampleRate, 0, WWVBSynthesizer::eBasebandCF32,
+								TimeCodeStation::kDCF77);
+	if (optind < argc ||
+		seconds == 0 ||
+		!synthesizer.Valid())
+	{
+		Usage();
+		return(1);
+	}
+	std::vector<float>	iq;
+	iq.reserve((size_t)seconds * sampleRate * 2);
+	synthesizer.SetSink(VectorSink, &iq);
+	ChannelModel	channel(sampleRate, 2, seed);
+	if (!isnan(snr))
+	{
+		channel.SetSignalLevel(0.9f);
+		channel.SetNoise(snr);
+		synthesizer.SetChannel(&channel);
+	}
+	uint64_t	samples;
+	if (!synthesizer.Stream(start, seconds, true, samples))
+	{
+		fprintf(stderr, "The synthesizer failed\n");
+		return(1);
+	}
+
+	TimeCodeEncoder	encoder(TimeCodeStation::kDCF77);
+	uint32_t	failures = 0;
+	float		minPeak = 1;
+	float		maxSidelobe = 0;
+	for (uint32_t i = 0; i < seconds; i++)
+	{
+		time32_t	time = start + i;
+		uint32_t	timeBit = encoder.Encode(time).GetSymbol(time % 60) & 1;
+		const float*	second = &iq[(size_t)i * sampleRate * 2];
+		float	peak = DCF77PRN::Correlate(second, sampleRate) * (timeBit ? -1 : 1);
+		float	sidelobe = 0;
+		int32_t	sidelobeLag = 0;
+		for (int32_t lag = 1; lag < (int32_t)DCF77PRN::kChips; lag += (lag < 16 ? 1 : 32))
+		{
+			for (int32_t sign = -1; sign <= 1; sign += 2)
+			{
+				float	correlation = fabsf(DCF77PRN::Correlate(second, sampleRate, lag * sign));
+				if (correlation > sidelobe)
+				{
+					sidelobe = correlation;
+					sidelobeLag = lag * sign;
+				}
+			}
+		}
+		if (peak < kMinPeak ||
+			sidelobe > kMaxSidelobe)
+		{
+			failures++;
+			fprintf(stderr, "%u (time bit %u): lag 0 %.3f, lag %d %.3f\n", time, timeBit,
+						peak, sidelobeLag, sidelobe);
+		}
+		minPeak = peak < minPeak ? peak : minPeak;
+		maxSidelobe = sidelobe > maxSidelobe ? sidelobe : maxSidelobe;
+	}
+	printf("%u seconds, lowest lag 0 %.3f, highest other lag %.3f, %u failed\n",
+		seconds, minPeak, maxSidelobe, failures);
+	return(failures ? 1 : 0);
+}
@@ -0,0 +1,342 @@
+/*
+*	TimestampCheck.cpp, Copyright Jonathan Mackey 2026
+*
+*	Checks TimestampParser and the UnixTime::StringToUnixTime overloads
+*	built on it: valid timestamps in every format, truncated strings, out
+*	of range fields, a buffer of mixed format lines, and random times
+*	round tripped through strftime.  The expected times come from the C
+*	library's timegm rather than from CivilCalendar.  Prints each failure
+*	and exits with 1 if there were any.
+*
+*	Build from the project directory:
+*		g++ -std=gnu++14 -O2 -ICore/Inc Host/TimestampCheck.cpp \
+*			$(find Core/Src -name '[A-Z]*.cpp') -o timestampcheck
+*
+*	Usage:
+*		./timestampcheck [random times, default 1000000]
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "TimestampParser.h"
+#include "UnixTime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+
+struct SCase
+{
+	const char*	string;
+	uint8_t		format;		// TimestampParser::EFormat, unknown = invalid
+	bool		timeIsUTC;
+	int32_t		offset;		// Seconds east of UTC
+	uint16_t	year;		// The time as written
+	uint8_t		month;
+	uint8_t		day;
+	uint8_t		hour;
+	uint8_t		minute;
+	uint8_t		second;
+};
+
+static const SCase	kValid[] =
+{
+	{"21/07/26,13:25:53-16\"", TimestampParser::eFormat_CCLK, false, -4 * 3600, 2021, 7, 26, 13, 25, 53},
+	{"21/07/26,13:25:53", TimestampParser::eFormat_CCLK, false, 0, 2021, 7, 26, 13, 25, 53},
+	{"21/07/26,17:25:53\",\"-16\",1", TimestampParser::eFormat_PSUTTZ, true, -4 * 3600, 2021, 7, 26, 17, 25, 53},
+	{"24/02/29,00:00:00+22", TimestampParser::eFormat_CCLK, false, 22 * 900, 2024, 2, 29, 0, 0, 0},
+	{"Mar-29-2023 09:08:00", TimestampParser::eFormat_Month, false, 0, 2023, 3, 29, 9, 8, 0},
+	{"dEC-09-2023T23:59:59", TimestampParser::eFormat_Month, false, 0, 2023, 12, 9, 23, 59, 59},
+	{"2023-03-29T09:08:00Z", TimestampParser::eFormat_ISO8601, true, 0, 2023, 3, 29, 9, 8, 0},
+	{"2023-03-29 09:08:00.123+05:30", TimestampParser::eFormat_ISO8601, false, 19800, 2023, 3, 29, 9, 8, 0},
+	{"2023-03-29t09:08:00-0800", TimestampParser::eFormat_ISO8601, false, -28800, 2023, 3, 29, 9, 8, 0},
+	{"2023-03-29T09:08:00+05", TimestampParser::eFormat_ISO8601, false, 18000, 2023, 3, 29, 9, 8, 0},
+	{"2023-03-29T09:08:00+0", TimestampParser::eFormat_ISO8601, false, 0, 2023, 3, 29, 9, 8, 0},
+	{"2000-02-29T12:00:00", TimestampParser::eFormat_ISO8601, false, 0, 2000, 2, 29, 12, 0, 0},
+	{"2016-12-31T23:59:60Z", TimestampParser::eFormat_ISO8601, true, 0, 2016, 12, 31, 23, 59, 60},
+	{"1970-01-01T00:00:00Z", TimestampParser::eFormat_ISO8601, true, 0, 1970, 1, 1, 0, 0, 0},
+	{"2106-02-07T06:28:15Z", TimestampParser::eFormat_ISO8601, true, 0, 2106, 2, 7, 6, 28, 15}
+};
+
+static const char*	kInvalid[] =
+{
+	"2023-02-29T00:00:00",		// Not a leap year
+	"2100-02-29T00:00:00",		// Not a leap year, divisible by 100
+	"2023-13-01T00:00:00",
+	"2023-00-10T00:00:00",
+	"2023-04-31T00:00:00",
+	"2023-03-00T00:00:00",
+	"2023-03-29T24:00:00",
+	"2023-03-29T09:60:00",
+	"2023-03-29T09:08:61",
+	"2106-02-07T06:28:16",		// Past the end of time32_t
+	"1969-12-31T23:59:59",		// Before 1970
+	"2023-03-2aT09:08:00",
+	"2023-03-29X09:08:00",
+	"2023/03/29T09:08:00",
+	"80/01/06,00:00:00+00",		// Modem without network time
+	"21/02/29,00:00:00",
+	"21/07/26;13:25:53",
+	"21/07/26,13:25:5x",
+	"Mar-32-2023 00:00:00",
+	"Xyz-01-2023 00:00:00",
+	"Mar-29-2023_09:08:00",
+	"Feb-29-1900 00:00:00",
+	"Mar-29-2023 09:08",
+	"hello, world, not a date"
+};
+
+static uint32_t	sFailures;
+
+/*********************************** Check ************************************/
+static void Check(
+	bool		inPassed,
+	const char*	inWhat,
+	const char*	inString)
+{
+	if (!inPassed)
+	{
+		fprintf(stderr, "FAIL %s: \"%s\"\n", inWhat, inString);
+		sFailures++;
+	}
+}
+
+/*********************************** TimeGM ***********************************/
+static time32_t TimeGM(
+	const SCase&	inCase)
+{
+	struct tm	components = {};
+	components.tm_year = inCase.year - 1900;
+	components.tm_mon = inCase.month - 1;
+	components.tm_mday = inCase.day;
+	components.tm_hour = inCase.hour;
+	components.tm_min = inCase.minute;
+	components.tm_sec = inCase.second;
+	return((time32_t)timegm(&components));
+}
+
+/********************************* CheckCases *********************************/
+static void CheckCases(void)
+{
+	for (const SCase& thisCase : kValid)
+	{
+		TimestampParser::STimestamp	timestamp;
+		time32_t	time = TimeGM(thisCase);
+		bool	parsed = TimestampParser::Parse(thisCase.string, strlen(thisCase.string), timestamp);
+		Check(parsed, "valid timestamp rejected", thisCase.string);
+		if (parsed)
+		{
+			Check(timestamp.time == time, "time", thisCase.string);
+			Check(timestamp.format == thisCase.format, "format", thisCase.string);
+			Check(timestamp.timeIsUTC == thisCase.timeIsUTC, "timeIsUTC", thisCase.string);
+			Check(timestamp.offset == thisCase.offset, "offset", thisCase.string);
+			Check(timestamp.UTC() == (thisCase.timeIsUTC ? time : (time - thisCase.offset)),
+				"UTC", thisCase.string);
+			Check(timestamp.Local() == (thisCase.timeIsUTC ? (time + thisCase.offset) : time),
+				"Local", thisCase.string);
+		}
+	}
+	for (const char* string : kInvalid)
+	{
+		TimestampParser::STimestamp	timestamp;
+		Check(!TimestampParser::Parse(string, strlen(string), timestamp),
+			"invalid timestamp accepted", string);
+	}
+}
+
+/******************************* CheckTruncated *******************************/
+/*
+*	Every valid case cut short of its seconds must be rejected, both by
+*	length and with the string copied and nul terminated.  The copy is
+*	heap allocated at its exact size so that a read past the end is caught
+*	by the address sanitizer.
+*/
+static void CheckTruncated(void)
+{
+	for (const SCase& thisCase : kValid)
+	{
+		size_t	minimum = thisCase.format == TimestampParser::eFormat_ISO8601 ? 19 :
+							(thisCase.format == TimestampParser::eFormat_Month ? 20 : 17);
+		for (size_t length = 0; length < minimum; length++)
+		{
+			TimestampParser::STimestamp	timestamp;
+			char*	copy = (char*)malloc(length + 1);
+			memcpy(copy, thisCase.string, length);
+			copy[length] = 0;
+			Check(!TimestampParser::Parse(copy, length, timestamp),
+				"truncated timestamp accepted", copy);
+			Check(UnixTime::StringToUnixTime(copy) == 0,
+				"StringToUnixTime of a truncated string", copy);
+			free(copy);
+		}
+	}
+}
+
+/*************************** CheckStringToUnixTime ****************************/
+/*
+*	StringToUnixTime returns the time as written, or with
+*	inAdjustForTimezone the local time, and 0 for anything invalid.
+*/
+static void CheckStringToUnixTime(void)
+{
+	const SCase&	cclk = kValid[0];
+	const SCase&	psuttz = kValid[2];
+	Check(UnixTime::StringToUnixTime(cclk.string) == TimeGM(cclk),
+		"StringToUnixTime CCLK", cclk.string);
+	Check(UnixTime::StringToUnixTime(psuttz.string, true) ==
+			(TimeGM(psuttz) + psuttz.offset),
+		"StringToUnixTime PSUTTZ adjusted", psuttz.string);
+	for (const char* string : kInvalid)
+	{
+		Check(UnixTime::StringToUnixTime(string) == 0,
+			"StringToUnixTime of an invalid string", string);
+		Check(UnixTime::StringToUnixTime(string, true) == 0,
+			"StringToUnixTime adjusted of an invalid string", string);
+	}
+	SCase	date = {"", 0, false, 0, 2023, 3, 29, 9, 8, 0};
+	Check(UnixTime::StringToUnixTime("Mar-29-2023", "09:08:00") == TimeGM(date),
+		"StringToUnixTime date and time", "Mar-29-2023 09:08:00");
+	Check(UnixTime::StringToUnixTime("Mar 29 2023", "09:08:00") == TimeGM(date),
+		"StringToUnixTime __DATE__ and time", "Mar 29 2023 09:08:00");
+	Check(UnixTime::StringToUnixTime("Mar-29-2023", "09:08") == 0,
+		"StringToUnixTime short time", "Mar-29-2023 09:08");
+	Check(UnixTime::StringToUnixTime("Mar-29", "09:08:00") == 0,
+		"StringToUnixTime short date", "Mar-29 09:08:00");
+	Check(UnixTime::StringToUnixTime("Mar-29-2023", "25:00:00") == 0,
+		"StringToUnixTime hour out of range", "Mar-29-2023 25:00:00");
+	Check(UnixTime::StringToUnixTime("Abc-29-2023", "09:08:00") == 0,
+		"StringToUnixTime unknown month", "Abc-29-2023 09:08:00");
+}
+
+/********************************* CheckLines *********************************/
+static void CheckLines(void)
+{
+	const SCase&	iso = kValid[6];
+	const SCase&	cclk = kValid[0];
+	const SCase&	month = kValid[4];
+	const SCase&	offset = kValid[7];
+	std::string	buffer = std::string(iso.string) + "\r\n" +
+							"\n" +
+							"not a time\n" +
+							cclk.string + "\n" +
+							month.string + "+junk\n" +
+							"2023-02-29T00:00:00\n" +
+							offset.string;	// No final newline
+	time32_t	expected[] =
+	{
+		TimeGM(iso),
+		0,
+		TimeGM(cclk) - cclk.offset,
+		TimeGM(month),
+		0,
+		TimeGM(offset) - offset.offset
+	};
+	const size_t	kExpected = sizeof(expected) / sizeof(time32_t);
+	time32_t	times[kExpected + 2];
+	size_t		consumed;
+	size_t		count = TimestampParser::ParseLines(buffer.data(), buffer.size(),
+									times, kExpected + 2, false, &consumed);
+	Check(count == kExpected && consumed == buffer.size(), "line count", buffer.c_str());
+	for (size_t i = 0; i < count && i < kExpected; i++)
+	{
+		Check(times[i] == expected[i], "line time", buffer.c_str());
+	}
+	// Local times
+	count = TimestampParser::ParseLines(buffer.data(), buffer.size(), times,
+									kExpected + 2, true);
+	Check(count == kExpected && times[2] == TimeGM(cclk) &&
+			times[5] == TimeGM(offset) && times[0] == TimeGM(iso),
+		"local line times", buffer.c_str());
+	// A full output array stops after the line that filled it.
+	count = TimestampParser::ParseLines(buffer.data(), buffer.size(), times, 2,
+									false, &consumed);
+	Check(count == 2 && buffer.compare(consumed, strlen(cclk.string), cclk.string) == 0,
+		"consumed when full", buffer.c_str());
+	// Resuming where it stopped gets the rest.
+	count = TimestampParser::ParseLines(&buffer[consumed], buffer.size() - consumed,
+									times, kExpected + 2);
+	Check(count == (kExpected - 2) && times[0] == expected[2] &&
+			times[count - 1] == expected[kExpected - 1],
+		"resumed lines", buffer.c_str());
+}
+
+/******************************* CheckRoundTrip *******************************/
+/*
+*	Random times formatted by strftime in each format, including upper and
+*	lower case month names, must parse back to the same time.
+*/
+static void CheckRoundTrip(
+	uint32_t	inCount)
+{
+	uint64_t	seed = 1;
+	for (uint32_t i = 0; i < inCount; i++)
+	{
+		uint64_t	z = (seed += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		time_t		time = (time32_t)(z ^ (z >> 31));
+		struct tm	components;
+		char		string[64];
+		gmtime_r(&time, &components);
+		switch (i % 3)
+		{
+			case 0:
+				strftime(string, sizeof(string), "%Y-%m-%dT%H:%M:%SZ", &components);
+				break;
+			case 1:
+				if (components.tm_year < 100 ||
+					components.tm_year >= 180)
+				{
+					continue;	// CCLK is 2000 to 2079
+				}
+				strftime(string, sizeof(string), "%y/%m/%d,%H:%M:%S+00", &components);
+				break;
+			default:
+				strftime(string, sizeof(string), "%b-%d-%Y %H:%M:%S", &components);
+				if (i & 8)
+				{
+					string[0] |= 0x20;
+					string[1] &= ~0x20;
+				}
+				break;
+		}
+		TimestampParser::STimestamp	timestamp;
+		Check(TimestampParser::Parse(string, strlen(string), timestamp) &&
+				timestamp.UTC() == (time32_t)time, "round trip", string);
+		if (sFailures > 20)
+		{
+			break;
+		}
+	}
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	uint32_t	count = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 1000000;
+	CheckCases();
+	CheckTruncated();
+	CheckStringToUnixTime();
+	CheckLines();
+	CheckRoundTrip(count);
+	printf("%u failures\n", sFailures);
+	return(sFailures ? 1 : 0);
+}
@@ -0,0 +1,182 @@
+/*
+*	WWVBMonteCarlo.cpp, Copyright Jonathan Mackey 2026
+*
+*	Command line tool that sweeps the SNR and prints a decoder's time to
+*	lock and frame error rate at each step (see MonteCarloHarness.)  The
+*	run time is reported on stderr.
+*
+*	Build from the project directory (add -march=native for AVX2):
+*		g++ -std=gnu++14 -O2 -pthread -ICore/Inc Host/WWVBMonteCarlo.cpp \
+*			$(find Core/Src -name '[A-Z]*.cpp') -o wwvbmontecarlo
+*
+*	Example:
+*		./wwvbmontecarlo -N -10,10,2 -n 1000 -x 10 -j 5000
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "MonteCarloHarness.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*********************************** Usage ************************************/
+static void Usage(void)
+{
+	fprintf(stderr,
+		"usage: wwvbmontecarlo [options]\n"
+		"  -s station   WWVB (default), DCF77, MSF or JJY\n"
+		"  -N a,b,step  SNR sweep in dB (default -10,10,2)\n"
+		"  -n trials    Trials per SNR (default 500)\n"
+		"  -x frames    Whole frames per trial (default 10)\n"
+		"  -r rate      Decoder sample rate in Hz, a multiple of 10 (default 1000)\n"
+		"  -T threads   Worker threads (default: one per core)\n"
+		"  -S seed      Seed (default 1)\n"
+		"  -g dB[,s]    Fading depth and period (default 10 s)\n"
+		"  -i n[,ms,dB] Noise bursts per second, their length (default 10 ms)\n"
+		"               and level relative to the carrier (default 0 dB)\n"
+		"  -O hz        Carrier offset\n"
+		"  -j us        Edge jitter, standard deviation\n"
+		"The SNR is over the sample bandwidth, i.e. the decoder sample rate.\n");
+}
+
+/********************************* ParseList **********************************/
+/*
+*	Parses up to inMax comma separated numbers into ioValues, leaving the
+*	values not given unchanged.
+*/
+static void ParseList(
+	const char*	inList,
+	float*		ioValues,
+	uint32_t	inMax)
+{
+	for (uint32_t i = 0; i < inMax && *inList; i++)
+	{
+		char*	end;
+		ioValues[i] = strtof(inList, &end);
+		inList = *end == ',' ? (end + 1) : end;
+	}
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	const STimeCodeStation*	station = &TimeCodeStation::kWWVB;
+	float		sweep[3] = {-10, 10, 2};	// dB
+	float		fading[2] = {0, 10};		// dB, s
+	float		impulses[3] = {0, 10, 0};	// per s, ms, dB
+	uint32_t	trials = 500;
+	uint32_t	frames = 10;
+	uint32_t	sampleRate = 1000;
+	uint32_t	threads = 0;
+	uint64_t	seed = 1;
+	MonteCarloHarness::SImpairments	impairments = {};
+	int			option;
+	while ((option = getopt(argc, argv, "s:N:n:x:r:T:S:g:i:O:j:h")) != -1)
+	{
+		switch (option)
+		{
+			case 's':
+				station = TimeCodeStation::Find(optarg);
+				if (!station)
+				{
+					fprintf(stderr, "Unknown station %s\n", optarg);
+					return(1);
+				}
+				break;
+			case 'N':
+				ParseList(optarg, sweep, 3);
+				break;
+			case 'n':
+				trials = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'x':
+				frames = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'r':
+				sampleRate = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'T':
+				threads = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'S':
+				seed = strtoull(optarg, nullptr, 10);
+				break;
+			case 'g':
+				ParseList(optarg, fading, 2);
+				break;
+			case 'i':
+				ParseList(optarg, impulses, 3);
+				break;
+			case 'O':
+				impairments.offset = strtof(optarg, nullptr);
+				break;
+			case 'j':
+				impairments.jitter = strtof(optarg, nullptr) / 1e6f;
+				break;
+			default:
+				Usage();
+				return(1);
+		}
+	}
+	if (sampleRate < 10 ||
+		(sampleRate % 10) != 0 ||
+		sweep[2] <= 0)
+	{
+		Usage();
+		return(1);
+	}
+	impairments.fadeDepth = fading[0];
+	impairments.fadePeriod = fading[1];
+	impairments.burstRate = impulses[0];
+	impairments.burstLength = impulses[1] / 1000;
+	impairments.burstLevel = impulses[2];
+	MonteCarloHarness	harness(*station, sampleRate);
+	harness.SetFrames(frames);
+	harness.SetThreads(threads);
+	printf("%s, %s decoder, %u trials of %u frames per SNR\n", station->name,
+		MonteCarloHarness::kReferenceDecoder.name, trials, frames);
+	printf("  SNR dB  locked %%  mean  median  90%%   FER %%  wrong\n");
+	std::chrono::steady_clock::time_point	startTime = std::chrono::steady_clock::now();
+	/*
+	*	Each SNR uses its own trial numbers so the points are independent.
+	*/
+	uint32_t	firstTrial = 0;
+	for (float snr = sweep[0]; snr <= (sweep[1] + (sweep[2] / 2)); snr += sweep[2])
+	{
+		impairments.snr = snr;
+		MonteCarloHarness::SResults	results = harness.Run(impairments, seed, trials, firstTrial);
+		firstTrial += trials;
+		printf("%8.1f  %7.1f  %4.1f  %6u  %3u  %6.2f  %5llu\n", snr,
+			results.trials ? (100.0 * results.Locked() / results.trials) : 0,
+			results.MeanFramesToLock(), results.FramesToLock(0.5f),
+			results.FramesToLock(0.9f), 100.0 * results.FrameErrorRate(),
+			(unsigned long long)results.wrong);
+		fflush(stdout);
+	}
+	double	elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+											startTime).count();
+	fprintf(stderr, "%.2f s on %u threads\n", elapsed, harness.Threads());
+	printf("The mean is of the trials that locked, the median and 90%% are of all\n"
+			"trials (0 = not reached.)\n");
+	return(0);
+}
@@ -0,0 +1,306 @@
+/*
+*	WWVBSynth.cpp, Copyright Jonathan Mackey 2026
+*
+*	Command line tool that streams the time code signal as sampled data
+*	(see WWVBSynthesizer.)  Throughput is reported on stderr.  In subharmonic
+*	mode the 20 kHz sound card signal is sent in real time starting at the
+*	next second of the host clock (see SubharmonicTransmitter), and the
+*	second edge latency is reported instead.  The carrier and baseband
+*	modes can be degraded by a ChannelModel.
+*
+*	Build from the project directory (add -march=native for AVX2):
+*		g++ -std=gnu++14 -O2 -ICore/Inc Host/WWVBSynth.cpp \
+*			$(find Core/Src -name '[A-Z]*.cpp') -o wwvbsynth
+*
+*	Examples:
+*		./wwvbsynth -r 1000000 -n 120 -o wwvb.s16
+*		./wwvbsynth -m baseband -r 250000 -p -n 60 | <SDR tool reading cf32>
+*		./wwvbsynth -m subharmonic -p -n 600 | aplay -t raw -f S16_LE -r 192000
+*		./wwvbsynth -m baseband -r 100000 -n 3600 -N 10 -g 20,30 -j 2000 -o hour.cf32
+*
+*	GNU license:
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*	Please maintain this license information along with authorship and copyright
+*	notices in any redistribution of this code.
+*
+*/
+#include "WWVBSynthesizer.h"
+#include "SubharmonicTransmitter.h"
+#include "ChannelModel.h"
+#include "LeapSeconds.h"
+#include <chrono>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*********************************** Usage ************************************/
+static void Usage(void)
+{
+	fprintf(stderr,
+		"usage: wwvbsynth [options]\n"
+		"  -s station   WWVB (default), DCF77, MSF or JJY\n"
+		"  -m mode      carrier (default), baseband or subharmonic\n"
+		"  -f format    s16 (default) or f32, carrier mode only\n"
+		"  -r rate      Sample rate in Hz, a multiple of 10 (default 1000000,\n"
+		"               192000 for subharmonic)\n"
+		"  -c hz        Carrier frequency, or the IF offset in baseband mode\n"
+		"               (default: the station's carrier, 0 for baseband)\n"
+		"  -t time      Start, Unix time (default: now, rounded to the minute)\n"
+		"  -n seconds   Length (default 60)\n"
+		"  -a level     Full carrier amplitude, 0 to 1 (default 0.9)\n"
+		"  -l dB        Reduced carrier level (default -17)\n"
+		"  -p           Add phase modulation (WWVB PM frame, DCF77 PRN)\n"
+		"  -L path      Load leap seconds from an IERS leap-seconds.list\n"
+		"  -o path      Output file (default stdout)\n"
+		"Channel impairments (carrier and baseband modes):\n"
+		"  -N dB        White noise at this SNR over the sample bandwidth\n"
+		"  -g dB[,s]    Fading depth and period (default 10 s)\n"
+		"  -i n[,ms,dB] Noise bursts per second, their length (default 10 ms)\n"
+		"               and level relative to the carrier (default 0 dB)\n"
+		"  -O hz        Carrier offset\n"
+		"  -j us        Edge jitter, standard deviation\n"
+		"  -S seed      Seed (default 1)\n"
+		"Subharmonic mode (WWVB only, -t is ignored):\n"
+		"  -B ms        Ring buffer length (default 200)\n"
+		"  -d us        Lead, i.e. the sink's output latency (default 0)\n"
+		"  -F           Don't pace to the host clock\n");
+}
+
+/********************************* ParseList **********************************/
+/*
+*	Parses up to inMax comma separated numbers into ioValues, leaving the
+*	values not given unchanged.
+*/
+static void ParseList(
+	const char*	inList,
+	float*		ioValues,
+	uint32_t	inMax)
+{
+	for (uint32_t i = 0; i < inMax && *inList; i++)
+	{
+		char*	end;
+		ioValues[i] = strtof(inList, &end);
+		inList = *end == ',' ? (end + 1) : end;
+	}
+}
+
+/************************************ main ************************************/
+int main(
+	int		argc,
+	char*	argv[])
+{
+	const STimeCodeStation*	station = &TimeCodeStation::kWWVB;
+	bool		baseband = false;
+	bool		subharmonic = false;
+	bool		paced = true;
+	bool		rateSet = false;
+	uint32_t	bufferMs = 200;
+	uint32_t	lead = 0;
+	bool		floatSamples = false;
+	bool		phaseModulation = false;
+	bool		frequencySet = false;
+	uint32_t	sampleRate = 1000000;
+	int32_t		frequency = 0;
+	time32_t	start = (time32_t)time(nullptr);
+	uint32_t	seconds = 60;
+	float		amplitude = 0.9f;
+	float		reducedLevel = -17;
+	const char*	outPath = nullptr;
+	bool		impaired = false;
+	float		snr = NAN;
+	float		fading[2] = {0, 10};		// dB, s
+	float		impulses[3] = {0, 10, 0};	// per s, ms, dB
+	float		offset = 0;
+	float		jitter = 0;
+	uint64_t	seed = 1;
+	int			option;
+	start -= start % 60;
+	while ((option = getopt(argc, argv, "s:m:f:r:c:t:n:a:l:pL:o:B:d:FN:g:i:O:j:S:h")) != -1)
+	{
+		switch (option)
+		{
+			case 's':
+				station = TimeCodeStation::Find(optarg);
+				if (!station)
+				{
+					fprintf(stderr, "Unknown station %s\n", optarg);
+					return(1);
+				}
+				break;
+			case 'm':
+				baseband = strcmp(optarg, "baseband") == 0;
+				subharmonic = strcmp(optarg, "subharmonic") == 0;
+				break;
+			case 'f':
+				floatSamples = strcmp(optarg, "f32") == 0;
+				break;
+			case 'r':
+				sampleRate = (uint32_t)strtoul(optarg, nullptr, 10);
+				rateSet = true;
+				break;
+			case 'c':
+				frequency = (int32_t)strtol(optarg, nullptr, 10);
+				frequencySet = true;
+				break;
+			case 't':
+				start = (time32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'n':
+				seconds = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'a':
+				amplitude = strtof(optarg, nullptr);
+				break;
+			case 'l':
+				reducedLevel = strtof(optarg, nullptr);
+				break;
+			case 'p':
+				phaseModulation = true;
+				break;
+			case 'L':
+				if (!LeapSeconds::LoadIERSList(optarg))
+				{
+					fprintf(stderr, "Couldn't load %s\n", optarg);
+					return(1);
+				}
+				break;
+			case 'o':
+				outPath = optarg;
+				break;
+			case 'B':
+				bufferMs = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'd':
+				lead = (uint32_t)strtoul(optarg, nullptr, 10);
+				break;
+			case 'F':
+				paced = false;
+				break;
+			case 'N':
+				snr = strtof(optarg, nullptr);
+				impaired = true;
+				break;
+			case 'g':
+				ParseList(optarg, fading, 2);
+				impaired = true;
+				break;
+			case 'i':
+				ParseList(optarg, impulses, 3);
+				impaired = true;
+				break;
+			case 'O':
+				offset = strtof(optarg, nullptr);
+				impaired = true;
+				break;
+			case 'j':
+				jitter = strtof(optarg, nullptr) / 1e6f;
+				impaired = true;
+				break;
+			case 'S':
+				seed = strtoull(optarg, nullptr, 10);
+				break;
+			default:
+				Usage();
+				return(1);
+		}
+	}
+	if (!frequencySet)
+	{
+		frequency = baseband ? 0 : (int32_t)station->carrierHz;
+	}
+	if (!baseband)
+	{
+		// A real carrier's offset is synthesized (see ChannelModel.)
+		frequency += (int32_t)lrintf(offset);
+	}
+	FILE*	outFile = outPath ? fopen(outPath, "wb") : stdout;
+	if (!outFile)
+	{
+		fprintf(stderr, "Couldn't open %s\n", outPath);
+		return(1);
+	}
+	bool	succeeded;
+	if (subharmonic)
+	{
+		SubharmonicTransmitter	transmitter(rateSet ? sampleRate : 192000,
+									(uint32_t)frequency, bufferMs);
+		if (!transmitter.Valid())
+		{
+			fprintf(stderr, "The sample rate must be a multiple of 100 and the "
+							"carrier a multiple of 3\n");
+			return(1);
+		}
+		transmitter.Synthesizer().SetAmplitude(amplitude);
+		transmitter.Synthesizer().SetReducedLevel(reducedLevel);
+		transmitter.SetSink(WWVBSynthesizer::FileSink, outFile);
+		transmitter.SetLead(lead);
+		transmitter.SetPaced(paced);
+		succeeded = transmitter.Run(seconds, phaseModulation);
+		const SubharmonicTransmitter::SLatency&	latency = transmitter.Latency();
+		if (paced)
+		{
+			fprintf(stderr, "Started at %u, %u second edges, latency min %d us, "
+							"mean %d us, max %d us, %u underruns\n",
+				transmitter.StartTime(), latency.edges, latency.minimum,
+				latency.Mean(), latency.maximum, latency.underruns);
+		}
+	} else
+	{
+		WWVBSynthesizer	synthesizer(sampleRate, frequency,
+							baseband ? WWVBSynthesizer::eBasebandCF32 :
+								(floatSamples ? WWVBSynthesizer::eCarrierF32 :
+												WWVBSynthesizer::eCarrierS16),
+							*station);
+		if (!synthesizer.Valid())
+		{
+			fprintf(stderr, "The sample rate must be a multiple of 10 and the "
+							"carrier period at most %u samples\n", WWVBSynthesizer::kMaxPeriod);
+			return(1);
+		}
+		synthesizer.SetAmplitude(amplitude);
+		synthesizer.SetReducedLevel(reducedLevel);
+		synthesizer.SetSink(WWVBSynthesizer::FileSink, outFile);
+		ChannelModel	channel(sampleRate, baseband ? 2 : 1, seed);
+		if (impaired)
+		{
+			channel.SetSignalLevel(amplitude);
+			channel.SetNoise(snr);
+			channel.SetFading(fading[0], fading[1]);
+			channel.SetImpulses(impulses[0], impulses[1] / 1000, impulses[2]);
+			channel.SetCarrierOffset(offset);
+			channel.SetEdgeJitter(jitter);
+			synthesizer.SetChannel(&channel);
+		}
+		std::chrono::steady_clock::time_point	startTime = std::chrono::steady_clock::now();
+		uint64_t	samples;
+		bool		streamed = synthesizer.Stream(start, seconds, phaseModulation, samples);
+		double		elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+												startTime).count();
+		// Jitter moves the last edge, so the length is only exact without it.
+		succeeded = streamed &&
+			(channel.HasEdgeJitter() || samples == ((uint64_t)seconds * sampleRate));
+		fprintf(stderr, "%s: %llu samples in %.3f s, %.1f MS/s (%s%s)\n", station->name,
+			(unsigned long long)samples, elapsed, elapsed > 0 ? (samples / elapsed / 1e6) : 0,
+			WWVBSynthesizer::InstructionSet(), impaired ? ", impaired" : "");
+	}
+	succeeded = succeeded && fflush(outFile) == 0 && !ferror(outFile);
+	if (outFile != stdout)
+	{
+		fclose(outFile);
+	}
+	return(succeeded ? 0 : 1);
+}